@@ -0,0 +1,87 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EGraphChangeJournal.h: Versioned record of the edits made to a graph.
+// Caches and precomputed data remember the version they were built for and ask for the changes since then,
+// so they only have to patch what changed. Only the most recent changes are kept, consumers that fall further
+// behind (or a graph that got cleared or rebuilt as a whole) have to rebuild everything.
+/*=============================================================================*/
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "EGraphEnums.h"
+
+namespace Elite
+{
+	enum class GraphChangeType
+	{
+		NodeAdded,
+		NodeRemoved,
+		ConnectionAdded,
+		ConnectionRemoved,
+		ConnectionCostChanged,
+		TerrainChanged
+	};
+
+	struct GraphChange
+	{
+		GraphChangeType type;
+		int from; // the node itself for node and terrain changes
+		int to;   // invalid_node_index for node and terrain changes
+	};
+
+	class GraphChangeJournal final
+	{
+	public:
+		explicit GraphChangeJournal(size_t capacity = 4096) : m_Capacity(capacity) {}
+
+		// Goes up with every change, starts at 0
+		uint64_t GetVersion() const { return m_Version; }
+
+		// Connection changes are recorded per direction, an undirected connection records both
+		void Record(GraphChangeType type, int from, int to = invalid_node_index);
+
+		// Everything may have changed, consumers of an older version have to rebuild
+		void RecordReset();
+
+		// Appends the changes made after the given version, oldest first.
+		// Returns false when those aren't known anymore, then everything has to be rebuilt
+		bool GetChangesSince(uint64_t version, std::vector<GraphChange>& changes) const;
+
+	private:
+		size_t m_Capacity;
+		uint64_t m_Version = 0;
+		uint64_t m_OldestVersion = 0; // the journal knows every change after this version
+		std::deque<GraphChange> m_Changes{};
+	};
+
+	inline void GraphChangeJournal::Record(GraphChangeType type, int from, int to)
+	{
+		m_Changes.push_back({ type, from, to });
+		++m_Version;
+
+		if (m_Changes.size() > m_Capacity)
+		{
+			m_Changes.pop_front();
+			++m_OldestVersion;
+		}
+	}
+
+	inline void GraphChangeJournal::RecordReset()
+	{
+		m_Changes.clear();
+		++m_Version;
+		m_OldestVersion = m_Version;
+	}
+
+	inline bool GraphChangeJournal::GetChangesSince(uint64_t version, std::vector<GraphChange>& changes) const
+	{
+		if (version < m_OldestVersion || version > m_Version)
+			return false;
+
+		changes.insert(changes.end(), m_Changes.begin() + size_t(version - m_OldestVersion), m_Changes.end());
+		return true;
+	}
+}
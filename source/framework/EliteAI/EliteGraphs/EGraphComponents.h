@@ -0,0 +1,72 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EGraphComponents.h: Union-find over the node indices of a graph, nodes with the same root lie in the same
+// connected component. Connections can only merge components, so removing one means starting over.
+/*=============================================================================*/
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace Elite
+{
+	class GraphComponents final
+	{
+	public:
+		// Every node becomes a component of its own
+		void Reset(int nrOfNodes);
+		// Added nodes start as a component of their own
+		void Resize(int nrOfNodes);
+
+		int GetNrOfNodes() const { return static_cast<int>(m_Parents.size()); }
+
+		int Find(int idx);
+		void Merge(int a, int b);
+
+	private:
+		std::vector<int> m_Parents{};
+		std::vector<int> m_Sizes{}; // only valid for roots
+	};
+
+	inline void GraphComponents::Reset(int nrOfNodes)
+	{
+		m_Parents.clear();
+		m_Sizes.clear();
+		Resize(nrOfNodes);
+	}
+
+	inline void GraphComponents::Resize(int nrOfNodes)
+	{
+		for (int idx = GetNrOfNodes(); idx < nrOfNodes; ++idx)
+		{
+			m_Parents.push_back(idx);
+			m_Sizes.push_back(1);
+		}
+	}
+
+	inline int GraphComponents::Find(int idx)
+	{
+		// path halving, every visited node skips to its grandparent
+		while (m_Parents[idx] != idx)
+		{
+			m_Parents[idx] = m_Parents[m_Parents[idx]];
+			idx = m_Parents[idx];
+		}
+		return idx;
+	}
+
+	inline void GraphComponents::Merge(int a, int b)
+	{
+		a = Find(a);
+		b = Find(b);
+		if (a == b)
+			return;
+
+		// the smaller tree goes under the bigger one, so the trees stay shallow
+		if (m_Sizes[a] < m_Sizes[b])
+			std::swap(a, b);
+		m_Parents[b] = a;
+		m_Sizes[a] += m_Sizes[b];
+	}
+}
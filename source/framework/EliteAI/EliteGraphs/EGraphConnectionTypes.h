@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <type_traits>
 #include "EGraphEnums.h"
 
 namespace Elite
@@ -39,6 +40,34 @@ namespace Elite
 		float m_Cost;
 	};
 
+	// Connection without a vtable, 12 bytes and trivially copyable. Pair it with CompactGridNode.
+	class CompactGraphConnection final
+	{
+	public:
+		explicit CompactGraphConnection(int from = invalid_node_index, int to = invalid_node_index, float cost = 1.f)
+			: m_From(from), m_To(to), m_Cost(cost) {}
+
+		int GetFrom() const { return m_From; }
+		void SetFrom(int newFrom) { m_From = newFrom; }
+
+		int GetTo() const { return m_To; }
+		void SetTo(int newTo) { m_To = newTo; }
+
+		float GetCost() const { return m_Cost; }
+		void SetCost(float newCost) { m_Cost = newCost; }
+
+		bool IsValid() const { return (m_From != -1 && m_To != -1); }
+
+		bool operator==(const CompactGraphConnection& rhs) const { return m_From == rhs.m_From && m_To == rhs.m_To && m_Cost == rhs.m_Cost; }
+		bool operator!=(const CompactGraphConnection& rhs) const { return !(*this == rhs); }
+
+	private:
+		int m_From;
+		int m_To;
+		float m_Cost;
+	};
+	static_assert(std::is_trivially_copyable<CompactGraphConnection>::value, "CompactGraphConnection has to stay memcpy-able");
+
 	class GraphConnection2D : public GraphConnection
 	{
 	public:
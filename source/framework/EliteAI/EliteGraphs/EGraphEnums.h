@@ -12,4 +12,25 @@ enum class TerrainType : int
 	Mud = 3,
 	// Node's with a value of over 200 000 are always isolated
 	Water = 200001
-};
\ No newline at end of file
+};
+
+// Terrain packed in a single byte, for compact nodes and files
+inline unsigned char GetTerrainByte(TerrainType terrain)
+{
+	switch (terrain)
+	{
+	case TerrainType::Mud: return 1;
+	case TerrainType::Water: return 2;
+	default: return 0;
+	}
+}
+
+inline TerrainType GetTerrainFromByte(unsigned char terrain)
+{
+	switch (terrain)
+	{
+	case 1: return TerrainType::Mud;
+	case 2: return TerrainType::Water;
+	default: return TerrainType::Ground;
+	}
+}
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <type_traits>
 #include "EGraphEnums.h"
 #include "EliteGraphUtilities/EGraphVisuals.h"
 
@@ -67,6 +68,37 @@ namespace Elite
 		TerrainType m_Terrain;
 	};
 
+	// Cost factor of a node's terrain, nodes without terrain behave like ground
+	inline float GetTerrainCost(const GraphNode* pNode) { return float(TerrainType::Ground); }
+	inline float GetTerrainCost(const GridTerrainNode* pNode) { return float(pNode->GetTerrainType()); }
+	inline void SetTerrainType(GraphNode* pNode, TerrainType terrain) {}
+	inline void SetTerrainType(GridTerrainNode* pNode, TerrainType terrain) { pNode->SetTerrainType(terrain); }
+
+	// Grid node without a vtable, the terrain is packed in a single byte so a cell fits in 8 bytes.
+	// Trivially copyable, a grid of these can be copied with a plain memcpy. Pair it with CompactGraphConnection.
+	class CompactGridNode final
+	{
+	public:
+		CompactGridNode() = default;
+		explicit CompactGridNode(int idx) : m_Index(idx) {}
+
+		int GetIndex() const { return m_Index; }
+		void SetIndex(int newIdx) { m_Index = newIdx; }
+
+		TerrainType GetTerrainType() const { return GetTerrainFromByte(m_Terrain); }
+		void SetTerrainType(TerrainType terrain) { m_Terrain = GetTerrainByte(terrain); }
+
+		bool operator==(const CompactGridNode& rhs) const { return m_Index == rhs.m_Index; }
+
+	private:
+		int m_Index = invalid_node_index;
+		unsigned char m_Terrain = 0;
+	};
+	static_assert(std::is_trivially_copyable<CompactGridNode>::value, "CompactGridNode has to stay memcpy-able");
+
+	inline float GetTerrainCost(const CompactGridNode* pNode) { return float(pNode->GetTerrainType()); }
+	inline void SetTerrainType(CompactGridNode* pNode, TerrainType terrain) { pNode->SetTerrainType(terrain); }
+
 
 	class NavGraphNode : public GraphNode2D
 	{
@@ -0,0 +1,187 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EGraphOverlay.h: Temporary edits on top of a graph, instead of cloning the whole graph for a single query.
+// Added nodes and connections and hidden ones are written into the graph itself and recorded, Revert (or the
+// destructor) undoes exactly those edits, so a query costs O(edits) instead of O(graph). Hidden connections go back to
+// their old place in the connection list, so the neighbour order (and with it the tie-breaking of searches) is kept.
+// The graph can't be modified through anything else while an overlay is active.
+// The edits don't show up in the change journal of the graph, they are gone again before anyone else sees the graph.
+/*=============================================================================*/
+#pragma once
+
+#include "EIGraph.h"
+
+namespace Elite
+{
+	template<class T_NodeType, class T_ConnectionType>
+	class GraphOverlay final
+	{
+	public:
+		explicit GraphOverlay(IGraph<T_NodeType, T_ConnectionType>* pGraph) : m_pGraph(pGraph) { ++m_pGraph->m_NrOfActiveOverlays; }
+		~GraphOverlay() { Revert(); --m_pGraph->m_NrOfActiveOverlays; }
+
+		GraphOverlay(const GraphOverlay&) = delete;
+		GraphOverlay& operator=(const GraphOverlay&) = delete;
+
+		IGraph<T_NodeType, T_ConnectionType>* GetGraph() const { return m_pGraph; }
+
+		// Adds a node at the next free index, the arguments are the ones after the index in the node's constructor
+		template<class... Args>
+		T_NodeType* AddNode(Args&&... args);
+
+		// Adds the opposite connection as well in an undirected graph, just like IGraph::AddConnection
+		void AddConnection(int from, int to, float cost);
+
+		// Detaches all connections of the node and marks it invalid, just like IGraph::RemoveNode
+		void HideNode(int idx);
+		void HideConnection(int from, int to);
+
+		void Revert();
+
+	private:
+		using ConnectionList = typename IGraph<T_NodeType, T_ConnectionType>::ConnectionList;
+
+		struct HiddenConnection
+		{
+			T_ConnectionType* pConnection;
+			int position; // in the connection list of the from node when it got hidden
+		};
+
+		void DetachConnection(int from, int to);
+		// returns the position the connection had, -1 if it wasn't there
+		static int EraseConnection(ConnectionList& connections, T_ConnectionType* pConnection);
+
+		IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+
+		std::vector<T_NodeType*> m_AddedNodes{};
+		std::vector<T_ConnectionType*> m_AddedConnections{};
+		std::vector<HiddenConnection> m_HiddenConnections{};
+		std::vector<int> m_HiddenNodes{};
+	};
+
+	template<class T_NodeType, class T_ConnectionType>
+	template<class... Args>
+	inline T_NodeType* GraphOverlay<T_NodeType, T_ConnectionType>::AddNode(Args&&... args)
+	{
+		T_NodeType* pNode = m_pGraph->CreateNode(m_pGraph->GetNextFreeNodeIndex(), std::forward<Args>(args)...);
+		m_pGraph->BatchAddNode(pNode);
+		m_AddedNodes.push_back(pNode);
+
+		m_pGraph->OnGraphModified(true, false);
+		return pNode;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void GraphOverlay<T_NodeType, T_ConnectionType>::AddConnection(int from, int to, float cost)
+	{
+		assert(m_pGraph->IsUniqueConnection(from, to) && "<GraphOverlay::AddConnection>: connection already exists on this graph");
+
+		T_ConnectionType* pConnection = m_pGraph->CreateConnection(from, to, cost);
+		m_pGraph->m_Connections[from].push_back(pConnection);
+		m_AddedConnections.push_back(pConnection);
+
+		if (!m_pGraph->m_IsDirectionalGraph && m_pGraph->IsUniqueConnection(to, from))
+		{
+			T_ConnectionType* pOpposite = m_pGraph->CreateConnection(to, from, cost);
+			m_pGraph->m_Connections[to].push_back(pOpposite);
+			m_AddedConnections.push_back(pOpposite);
+		}
+
+		m_pGraph->OnGraphModified(false, true);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void GraphOverlay<T_NodeType, T_ConnectionType>::HideNode(int idx)
+	{
+		// removing a node that was added by this overlay would need to be undone before it gets popped again
+		assert(idx < m_pGraph->GetNrOfNodes() - int(m_AddedNodes.size()) && "<GraphOverlay::HideNode>: can only hide nodes of the graph");
+
+		const ConnectionList connections = m_pGraph->m_Connections[idx];
+		for (T_ConnectionType* pConnection : connections)
+		{
+			if (!m_pGraph->m_IsDirectionalGraph)
+				DetachConnection(pConnection->GetTo(), idx);
+			DetachConnection(idx, pConnection->GetTo());
+		}
+
+		m_pGraph->GetNode(idx)->SetIndex(invalid_node_index);
+		m_HiddenNodes.push_back(idx);
+
+		m_pGraph->OnGraphModified(true, !connections.empty());
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void GraphOverlay<T_NodeType, T_ConnectionType>::HideConnection(int from, int to)
+	{
+		if (!m_pGraph->m_IsDirectionalGraph)
+			DetachConnection(to, from);
+		DetachConnection(from, to);
+
+		m_pGraph->OnGraphModified(false, true);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void GraphOverlay<T_NodeType, T_ConnectionType>::Revert()
+	{
+		if (m_AddedNodes.empty() && m_AddedConnections.empty() && m_HiddenConnections.empty() && m_HiddenNodes.empty())
+			return;
+
+		// hidden connections go back first, they can include connections that this overlay added.
+		// Last hidden first: every list is then the same as right after that connection got hidden, added ones only went to the back
+		for (auto it = m_HiddenConnections.rbegin(); it != m_HiddenConnections.rend(); ++it)
+		{
+			ConnectionList& connections = m_pGraph->m_Connections[it->pConnection->GetFrom()];
+			connections.insert(connections.begin() + it->position, it->pConnection);
+		}
+
+		for (T_ConnectionType* pConnection : m_AddedConnections)
+		{
+			EraseConnection(m_pGraph->m_Connections[pConnection->GetFrom()], pConnection);
+			m_pGraph->DestroyConnection(pConnection);
+		}
+
+		for (int idx : m_HiddenNodes)
+			m_pGraph->GetNode(idx)->SetIndex(idx);
+
+		// added nodes always went to the back of the graph, remove them last to first
+		for (auto it = m_AddedNodes.rbegin(); it != m_AddedNodes.rend(); ++it)
+		{
+			m_pGraph->DestroyNode(m_pGraph->m_Nodes.back());
+			m_pGraph->m_Nodes.pop_back();
+			m_pGraph->m_Connections.pop_back();
+			--m_pGraph->m_NextNodeIndex;
+		}
+
+		const bool nrOfNodesChanged = !m_AddedNodes.empty() || !m_HiddenNodes.empty();
+		m_AddedNodes.clear();
+		m_AddedConnections.clear();
+		m_HiddenConnections.clear();
+		m_HiddenNodes.clear();
+
+		m_pGraph->OnGraphModified(nrOfNodesChanged, true);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void GraphOverlay<T_NodeType, T_ConnectionType>::DetachConnection(int from, int to)
+	{
+		T_ConnectionType* pConnection = m_pGraph->GetConnection(from, to);
+		if (!pConnection)
+			return;
+
+		const int position = EraseConnection(m_pGraph->m_Connections[from], pConnection);
+		m_HiddenConnections.push_back({ pConnection, position });
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline int GraphOverlay<T_NodeType, T_ConnectionType>::EraseConnection(ConnectionList& connections, T_ConnectionType* pConnection)
+	{
+		auto foundIt = std::find(connections.begin(), connections.end(), pConnection);
+		if (foundIt == connections.end())
+			return -1;
+
+		const int position = int(foundIt - connections.begin());
+		connections.erase(foundIt);
+		return position;
+	}
+}
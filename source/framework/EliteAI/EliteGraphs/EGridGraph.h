@@ -9,16 +9,37 @@
 #include "EIGraph.h"
 #include "EGraphConnectionTypes.h"
 #include "EGraphNodeTypes.h"
+#include "framework/EliteHelpers/EBinaryFile.h"
 
 namespace Elite
 {
-	template<class T_NodeType, class T_ConnectionType>
+	// Movement policies: decide which neighbours a grid connects and which pruning rules a grid search may apply
+	struct AllowCornerCutting
+	{
+		static constexpr bool IsDiagonalAllowed = true;
+		static constexpr bool IsCornerCuttingAllowed = true; // diagonal moves may pass a blocked orthogonal cell
+	};
+
+	struct NoCornerCutting
+	{
+		static constexpr bool IsDiagonalAllowed = true;
+		static constexpr bool IsCornerCuttingAllowed = false;
+	};
+
+	struct FourConnected
+	{
+		static constexpr bool IsDiagonalAllowed = false;
+		static constexpr bool IsCornerCuttingAllowed = false;
+	};
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy = AllowCornerCutting>
 	class GridGraph : public IGraph<T_NodeType, T_ConnectionType>
 	{
 	public:
 		GridGraph(bool isDirectional);
 		GridGraph(int columns, int rows, int cellSize, bool isDirectionalGraph, bool isConnectedDiagonally, float costStraight = 1.f, float costDiagonal = 1.5);
-		void InitializeGrid(int columns, int rows, int cellSize, bool isDirectionalGraph, bool isConnectedDiagonally, float costStraight = 1.f, float costDiagonal = 1.5);
+		// Builds all nodes and connections in one pass. The terrain holds a byte per cell (see GetTerrainByte), without it every cell is ground
+		void InitializeGrid(int columns, int rows, int cellSize, bool isDirectionalGraph, bool isConnectedDiagonally, float costStraight = 1.f, float costDiagonal = 1.5, const uint8_t* pTerrain = nullptr);
 
 		using IGraph::GetNode;
 		T_NodeType* GetNode(int col, int row) const { return m_Nodes[GetIndex(col, row)]; }
@@ -29,6 +50,7 @@ namespace Elite
 		int GetColumns() const { return m_NrOfColumns; }
 
 		bool IsWithinBounds(int col, int row) const;
+		bool IsWalkable(int col, int row) const;
 		int GetIndex(int col, int row) const { return row * m_NrOfColumns + col; }
 
 		// returns the column and row of the node in a Vector2
@@ -44,7 +66,37 @@ namespace Elite
 
 		void AddConnectionsToAdjacentCells(int col, int row);
 		void AddConnectionsToAdjacentCells(int idx);
+
+		// Hides IGraph::RemoveConnectionsToAdjacentNodes so the movement policy is honoured around the isolated cell
+		void RemoveConnectionsToAdjacentNodes(int idx);
+
+		// Sets the terrain of the cells in the rectangle (clipped to the grid) and updates the connections around them.
+		// Raises OnGraphModified once, so it is much cheaper than changing the cells one by one
+		void SetTerrainRegion(int col, int row, int width, int height, TerrainType terrain);
+
+		// Writes the settings of the grid and the terrain of every cell as a byte.
+		// Load replaces the grid with the one in the file, returns false if the file has no (valid) grid
+		void Save(BinaryFileWriter& file) const;
+		bool Load(const BinaryFileView& file);
+		// Size of the grid in the file without loading it, returns false if the file has no (valid) grid
+		static bool GetFileGridSize(const BinaryFileView& file, int& columns, int& rows);
 	private:
+		struct FileSettings
+		{
+			int32_t columns;
+			int32_t rows;
+			int32_t cellSize;
+			uint8_t isDirectionalGraph;
+			uint8_t isConnectedDiagonally;
+			uint8_t padding[2];
+			float costStraight;
+			float costDiagonal;
+		};
+		static constexpr uint32_t FileSettingsId = CompileTimeLiteralStringHash("GridGraphSettings");
+		static constexpr uint32_t FileTerrainId = CompileTimeLiteralStringHash("GridGraphTerrain");
+
+		// nullptr if the file has no (valid) grid
+		static const FileSettings* GetFileSettings(const BinaryFileView& file, const uint8_t*& pTerrain);
 		
 		int m_NrOfColumns;
 		int m_NrOfRows;
@@ -58,15 +110,21 @@ namespace Elite
 		const vector<Vector2> m_DiagonalDirections = { { 1, 1 }, { -1, 1 }, { -1, -1 }, { 1, -1 } };
 
 		// graph creation helper functions
-		void AddConnectionsInDirections(int idx, int col, int row, vector<Vector2> directions);
+		void CreateNodesAndConnections(const uint8_t* pTerrain);
+		void AddConnectionsInDirections(int idx, int col, int row, const vector<Vector2>& directions);
+		void AddConnectionsAroundCorners(int col, int row);
+		void RemoveConnectionsAroundCorners(int col, int row);
 
 		float CalculateConnectionCost(int fromIdx, int toIdx) const;
+		// Cost of the connection between two adjacent cells, negative when the terrain or the movement policy doesn't allow it
+		float GetAdjacentConnectionCost(int col, int row, int neighborCol, int neighborRow) const;
+		bool HasDiagonalConnections() const { return m_IsConnectedDiagonally && T_MovementPolicy::IsDiagonalAllowed; }
 	
 		friend class EGraphRenderer;
 	};
 
-	template<class T_NodeType, class T_ConnectionType>
-	inline GridGraph<T_NodeType, T_ConnectionType>::GridGraph(bool isDirectional)
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GridGraph(bool isDirectional)
 		: IGraph(isDirectional)
 		, m_NrOfColumns(0)
 		, m_NrOfRows(0)
@@ -77,8 +135,8 @@ namespace Elite
 	{
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	GridGraph<T_NodeType, T_ConnectionType>::GridGraph(
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GridGraph(
 		int columns,
 		int rows, 
 		int cellSize, 
@@ -97,15 +155,16 @@ namespace Elite
 		InitializeGrid(columns, rows, cellSize, isDirectionalGraph, isConnectedDiagonally, costStraight, costDiagonal);
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	inline void GridGraph<T_NodeType, T_ConnectionType>::InitializeGrid(
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::InitializeGrid(
 		int columns, 
 		int rows, 
 		int cellSize, 
 		bool isDirectionalGraph,
 		bool isConnectedDiagonally, 
 		float costStraight /* = 1.f*/,
-		float costDiagonal /* = 1.5f */)
+		float costDiagonal /* = 1.5f */,
+		const uint8_t* pTerrain /* = nullptr */)
 	{
 		m_IsDirectionalGraph = isDirectionalGraph;
 		m_NrOfColumns = columns;
@@ -115,95 +174,307 @@ namespace Elite
 		m_DefaultCostStraight = costStraight;
 		m_DefaultCostDiagonal = costDiagonal;
 
-		// Create all nodes
+		CreateNodesAndConnections(pTerrain);
+		OnGraphModified(true, true);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::CreateNodesAndConnections(const uint8_t* pTerrain)
+	{
+		// Every cell has at most 4 or 8 connections, so all of them fit in one block
+		const int nrOfCells = m_NrOfColumns * m_NrOfRows;
+		ReserveStorage(nrOfCells, nrOfCells * (HasDiagonalConnections() ? 8 : 4));
+
+		// Create all nodes, the terrain has to be known before the connections get their cost
+		for (auto idx = 0; idx < nrOfCells; ++idx)
+		{
+			BatchAddNode(CreateNode(idx));
+			m_Connections[idx].reserve(HasDiagonalConnections() ? 8 : 4);
+			if (pTerrain)
+				SetTerrainType(GetNode(idx), GetTerrainFromByte(pTerrain[idx]));
+		}
+
+		// Every cell makes its own outgoing connections, so no connection has to be looked up.
+		// The events are left to the caller, which raises one for the whole grid
+		const int nrOfDirections = HasDiagonalConnections() ? 8 : 4;
 		for (auto r = 0; r < m_NrOfRows; ++r)
 		{
 			for (auto c = 0; c < m_NrOfColumns; ++c)
 			{
-				int idx = GetIndex(c, r);
-				AddNode(new T_NodeType(idx));
+				const int idx = GetIndex(c, r);
+				for (auto d = 0; d < nrOfDirections; ++d)
+				{
+					const Vector2& direction = d < 4 ? m_StraightDirections[d] : m_DiagonalDirections[d - 4];
+					const int neighborCol = c + int(direction.x);
+					const int neighborRow = r + int(direction.y);
+
+					const float cost = GetAdjacentConnectionCost(c, r, neighborCol, neighborRow);
+					if (cost >= 0.f)
+						BatchAddConnection(CreateConnection(idx, GetIndex(neighborCol, neighborRow), cost));
+				}
 			}
 		}
 
-		// Create connections in each valid direction on each node
-		for (auto r = 0; r < m_NrOfRows; ++r)
+		// Too many changes to record one by one
+		m_ChangeJournal.RecordReset();
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::SetTerrainRegion(int col, int row, int width, int height, TerrainType terrain)
+	{
+		const int fromCol = std::max(col, 0);
+		const int fromRow = std::max(row, 0);
+		const int toCol = std::min(col + width, m_NrOfColumns);
+		const int toRow = std::min(row + height, m_NrOfRows);
+		if (fromCol >= toCol || fromRow >= toRow)
+			return;
+
+		for (auto r = fromRow; r < toRow; ++r)
 		{
-			for (auto c = 0; c < m_NrOfColumns; ++c)
+			for (auto c = fromCol; c < toCol; ++c)
+			{
+				SetTerrainType(GetNode(c, r), terrain);
+				m_ChangeJournal.Record(GraphChangeType::TerrainChanged, GetIndex(c, r));
+			}
+		}
+
+		// Only connections inside the region grown by one cell can change: their cost depends on the terrain of both ends
+		// and a diagonal also depends on the two cells at its corners, which are neighbours of both ends
+		const int minCol = std::max(fromCol - 1, 0);
+		const int minRow = std::max(fromRow - 1, 0);
+		const int maxCol = std::min(toCol + 1, m_NrOfColumns);
+		const int maxRow = std::min(toRow + 1, m_NrOfRows);
+		const int nrOfDirections = HasDiagonalConnections() ? 8 : 4;
+
+		for (auto r = minRow; r < maxRow; ++r)
+		{
+			for (auto c = minCol; c < maxCol; ++c)
 			{
-				AddConnectionsToAdjacentCells(c, r);
+				const int idx = GetIndex(c, r);
+				for (auto d = 0; d < nrOfDirections; ++d)
+				{
+					const Vector2& direction = d < 4 ? m_StraightDirections[d] : m_DiagonalDirections[d - 4];
+					const int neighborCol = c + int(direction.x);
+					const int neighborRow = r + int(direction.y);
+					if (neighborCol < minCol || neighborCol >= maxCol || neighborRow < minRow || neighborRow >= maxRow)
+						continue;
+
+					const int neighborIdx = GetIndex(neighborCol, neighborRow);
+					const float cost = GetAdjacentConnectionCost(c, r, neighborCol, neighborRow);
+					T_ConnectionType* pConnection = GetConnection(idx, neighborIdx);
+
+					if (cost < 0.f)
+					{
+						if (!pConnection)
+							continue;
+
+						BatchRemoveConnection(idx, neighborIdx);
+						m_ChangeJournal.Record(GraphChangeType::ConnectionRemoved, idx, neighborIdx);
+					}
+					else if (!pConnection)
+					{
+						BatchAddConnection(CreateConnection(idx, neighborIdx, cost));
+						m_ChangeJournal.Record(GraphChangeType::ConnectionAdded, idx, neighborIdx);
+					}
+					else if (pConnection->GetCost() != cost)
+					{
+						pConnection->SetCost(cost);
+						m_ChangeJournal.Record(GraphChangeType::ConnectionCostChanged, idx, neighborIdx);
+					}
+				}
 			}
 		}
+
+		OnGraphModified(false, true);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::Save(BinaryFileWriter& file) const
+	{
+		const FileSettings settings{
+			m_NrOfColumns,
+			m_NrOfRows,
+			m_CellSize,
+			uint8_t(m_IsDirectionalGraph),
+			uint8_t(m_IsConnectedDiagonally),
+			{ 0, 0 },
+			m_DefaultCostStraight,
+			m_DefaultCostDiagonal };
+		file.AddSection(FileSettingsId, &settings, 1);
+
+		std::vector<uint8_t> terrain(m_Nodes.size());
+		for (size_t idx = 0; idx < m_Nodes.size(); ++idx)
+			terrain[idx] = GetTerrainByte(TerrainType(int(GetTerrainCost(m_Nodes[idx]))));
+		file.AddSection(FileTerrainId, terrain);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	auto GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetFileSettings(const BinaryFileView& file, const uint8_t*& pTerrain) -> const FileSettings*
+	{
+		size_t count = 0;
+		const FileSettings* pSettings = file.GetSection<FileSettings>(FileSettingsId, count);
+		if (!pSettings || count != 1 || pSettings->columns < 0 || pSettings->rows < 0)
+			return nullptr;
+
+		pTerrain = file.GetSection<uint8_t>(FileTerrainId, count);
+		if (!pTerrain || count != size_t(pSettings->columns) * size_t(pSettings->rows))
+			return nullptr;
+
+		return pSettings;
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	bool GridGraph<T_NodeType, T_ConnectionType>::IsWithinBounds(int col, int row) const
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	bool GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetFileGridSize(const BinaryFileView& file, int& columns, int& rows)
+	{
+		const uint8_t* pTerrain = nullptr;
+		const FileSettings* pSettings = GetFileSettings(file, pTerrain);
+		if (!pSettings)
+			return false;
+
+		columns = pSettings->columns;
+		rows = pSettings->rows;
+		return true;
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	bool GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::Load(const BinaryFileView& file)
+	{
+		const uint8_t* pTerrain = nullptr;
+		const FileSettings* pSettings = GetFileSettings(file, pTerrain);
+		if (!pSettings)
+			return false;
+
+		Clear();
+		m_IsDirectionalGraph = pSettings->isDirectionalGraph != 0;
+		m_NrOfColumns = pSettings->columns;
+		m_NrOfRows = pSettings->rows;
+		m_CellSize = pSettings->cellSize;
+		m_IsConnectedDiagonally = pSettings->isConnectedDiagonally != 0;
+		m_DefaultCostStraight = pSettings->costStraight;
+		m_DefaultCostDiagonal = pSettings->costDiagonal;
+
+		CreateNodesAndConnections(pTerrain);
+		OnGraphModified(true, true);
+		return true;
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	bool GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::IsWithinBounds(int col, int row) const
 	{
 		return (col >= 0 && col < m_NrOfColumns && row >= 0 && row < m_NrOfRows);
 	}
 
 
-	template<class T_NodeType, class T_ConnectionType>
-	void GridGraph<T_NodeType, T_ConnectionType>::AddConnectionsToAdjacentCells(int col, int row)
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline bool GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::IsWalkable(int col, int row) const
+	{
+		return IsWithinBounds(col, row) && GetTerrainCost(GetNode(col, row)) < float(TerrainType::Water);
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::AddConnectionsToAdjacentCells(int col, int row)
 	{
 		int idx = GetIndex(col, row);
 
 		// Add connections in all directions, taking into account the dimensions of the grid
 		AddConnectionsInDirections(idx, col, row, m_StraightDirections);
 
-		if (m_IsConnectedDiagonally)
+		if (HasDiagonalConnections())
 		{
 			AddConnectionsInDirections(idx, col, row, m_DiagonalDirections);
+
+			// diagonals between our neighbours might have been waiting for this cell to become walkable
+			if (!T_MovementPolicy::IsCornerCuttingAllowed)
+				AddConnectionsAroundCorners(col, row);
 		}
 
 		OnGraphModified(false, true);
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	inline void GridGraph<T_NodeType, T_ConnectionType>::AddConnectionsToAdjacentCells(int idx)
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::AddConnectionsToAdjacentCells(int idx)
 	{
 		auto colRow = GetNodePos(idx);
 		AddConnectionsToAdjacentCells((int)colRow.x, (int)colRow.y);
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	void GridGraph<T_NodeType, T_ConnectionType>::AddConnectionsInDirections(int idx, int col, int row, vector<Elite::Vector2> directions)
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::RemoveConnectionsToAdjacentNodes(int idx)
 	{
-		for (auto d : directions)
+		IGraph::RemoveConnectionsToAdjacentNodes(idx);
+
+		if (HasDiagonalConnections() && !T_MovementPolicy::IsCornerCuttingAllowed)
+		{
+			auto colRow = GetNodePos(idx);
+			RemoveConnectionsAroundCorners((int)colRow.x, (int)colRow.y);
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::AddConnectionsInDirections(int idx, int col, int row, const vector<Elite::Vector2>& directions)
+	{
+		for (const auto& d : directions)
 		{
 			int neighborCol = col + (int)d.x;
 			int neighborRow = row + (int)d.y;
-			
-			if (IsWithinBounds(neighborCol, neighborRow)) 
-			{
-				int neighborIdx = neighborRow * m_NrOfColumns + neighborCol;
-				float connectionCost = CalculateConnectionCost(idx, neighborIdx);
 
-				if (IsUniqueConnection(idx, neighborIdx) 
-					&& connectionCost < 100000) //Extra check for different terrain types
-					AddConnection(new GraphConnection(idx, neighborIdx, connectionCost));
+			float connectionCost = GetAdjacentConnectionCost(col, row, neighborCol, neighborRow);
+			if (connectionCost < 0.f)
+				continue;
+
+			int neighborIdx = GetIndex(neighborCol, neighborRow);
+			if (IsUniqueConnection(idx, neighborIdx))
+				AddConnection(CreateConnection(idx, neighborIdx, connectionCost));
+			else
+			{
+				// the terrain might have changed since the connection was made
+				SetConnectionCost(idx, neighborIdx, connectionCost);
+				SetConnectionCost(neighborIdx, idx, connectionCost);
 			}
 		}
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	inline float GridGraph<T_NodeType, T_ConnectionType>::CalculateConnectionCost(int fromIdx, int toIdx) const
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::AddConnectionsAroundCorners(int col, int row)
 	{
-		float cost = m_DefaultCostStraight;
+		// every diagonal that passes a corner of this cell connects two of its orthogonal neighbours
+		for (auto d : m_DiagonalDirections)
+		{
+			int fromCol = col + (int)d.x;
+			int toRow = row + (int)d.y;
 
-		Vector2 fromPos = GetNodePos(fromIdx);
-		Vector2 toPos = GetNodePos(toIdx);
+			if (!IsWithinBounds(fromCol, row) || !IsWithinBounds(col, toRow))
+				continue;
 
-		if (int(fromPos.y) != int(toPos.y) &&
-			int(fromPos.x) != int(toPos.x))
-		{
-			cost = m_DefaultCostDiagonal;
+			AddConnectionsInDirections(GetIndex(fromCol, row), fromCol, row, { Vector2{ -d.x, d.y } });
+			if (m_IsDirectionalGraph)
+				AddConnectionsInDirections(GetIndex(col, toRow), col, toRow, { Vector2{ d.x, -d.y } });
 		}
+	}
 
-		return cost;
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::RemoveConnectionsAroundCorners(int col, int row)
+	{
+		for (auto d : m_DiagonalDirections)
+		{
+			int fromCol = col + (int)d.x;
+			int toRow = row + (int)d.y;
+
+			if (!IsWithinBounds(fromCol, row) || !IsWithinBounds(col, toRow))
+				continue;
+
+			int fromIdx = GetIndex(fromCol, row);
+			int toIdx = GetIndex(col, toRow);
+
+			if (GetConnection(fromIdx, toIdx))
+				RemoveConnection(fromIdx, toIdx);
+			if (GetConnection(toIdx, fromIdx))
+				RemoveConnection(toIdx, fromIdx);
+		}
 	}
 
-	template<>
-	inline float GridGraph<GridTerrainNode, GraphConnection>::CalculateConnectionCost(int fromIdx, int toIdx) const
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline float GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::CalculateConnectionCost(int fromIdx, int toIdx) const
 	{
 		float cost = m_DefaultCostStraight;
 
@@ -216,13 +487,32 @@ namespace Elite
 			cost = m_DefaultCostDiagonal;
 		}
 
-		cost *= (int(GetNode(fromIdx)->GetTerrainType()) + int(GetNode(toIdx)->GetTerrainType())) / 2.0f;
+		cost *= (GetTerrainCost(GetNode(fromIdx)) + GetTerrainCost(GetNode(toIdx))) / 2.0f;
 
 		return cost;
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	Elite::Vector2 GridGraph<T_NodeType, T_ConnectionType>::GetNodePos(T_NodeType* pNode) const
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline float GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetAdjacentConnectionCost(int col, int row, int neighborCol, int neighborRow) const
+	{
+		if (!IsWithinBounds(neighborCol, neighborRow))
+			return -1.f;
+
+		// a diagonal may not squeeze past a blocked orthogonal cell when the policy forbids corner cutting
+		const bool isDiagonal = neighborCol != col && neighborRow != row;
+		if (isDiagonal && !T_MovementPolicy::IsCornerCuttingAllowed
+			&& (!IsWalkable(neighborCol, row) || !IsWalkable(col, neighborRow)))
+			return -1.f;
+
+		float connectionCost = CalculateConnectionCost(GetIndex(col, row), GetIndex(neighborCol, neighborRow));
+		if (connectionCost >= 100000) //Extra check for different terrain types
+			return -1.f;
+
+		return connectionCost;
+	}
+
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	Elite::Vector2 GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetNodePos(T_NodeType* pNode) const
 	{
 		auto col = pNode->GetIndex() % m_NrOfColumns;
 		auto row = pNode->GetIndex() / m_NrOfColumns;
@@ -230,22 +520,22 @@ namespace Elite
 		return Vector2{ float(col), float(row) };
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	Elite::Vector2 GridGraph<T_NodeType, T_ConnectionType>::GetNodeWorldPos(int col, int row) const
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	Elite::Vector2 GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetNodeWorldPos(int col, int row) const
 	{
 		Vector2 cellCenterOffset = { m_CellSize / 2.f, m_CellSize / 2.f };
 		return Vector2{ (float)col * m_CellSize, (float)row * m_CellSize } +cellCenterOffset;
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	Elite::Vector2 GridGraph<T_NodeType, T_ConnectionType>::GetNodeWorldPos(int idx) const
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	Elite::Vector2 GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetNodeWorldPos(int idx) const
 	{
 		auto colRow = GetNodePos(idx);
 		return GetNodeWorldPos((int)colRow.x, (int)colRow.y);
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	inline int GridGraph<T_NodeType, T_ConnectionType>::GetNodeIdxAtWorldPos(const Elite::Vector2& pos) const
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline int GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetNodeIdxAtWorldPos(const Elite::Vector2& pos) const
 	{
 		int idx = invalid_node_index;
 
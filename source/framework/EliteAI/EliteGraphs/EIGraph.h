@@ -9,6 +9,9 @@
 
 #include "EGraphNodeTypes.h"
 #include "EGraphConnectionTypes.h"
+#include "EGraphChangeJournal.h"
+#include "EGraphComponents.h"
+#include "framework/EliteHelpers/EObjectArena.h"
 #include <memory>
 
 namespace Elite
@@ -19,7 +22,7 @@ namespace Elite
 	public:
 		// shorthand typedefs
 		using NodeVector = std::vector<T_NodeType*>;
-		using ConnectionList = std::list<T_ConnectionType*>; // TODO: function definition doesn't recognize this?
+		using ConnectionList = std::vector<T_ConnectionType*>; // TODO: function definition doesn't recognize this?
 		using ConnectionListVector = std::vector<ConnectionList>;
 
 	public:
@@ -39,6 +42,12 @@ namespace Elite
 		const ConnectionList& GetNodeConnections(int idx) const;
 		const ConnectionList& GetNodeConnections(T_NodeType* pNode) const { return GetNodeConnections(pNode->GetIndex()); }
 
+		// Nodes and connections are owned by the graph, create them here before adding them
+		template<class... Args>
+		T_NodeType* CreateNode(Args&&... args) { return m_NodeArena.Create(std::forward<Args>(args)...); }
+		template<class... Args>
+		T_ConnectionType* CreateConnection(Args&&... args) { return m_ConnectionArena.Create(std::forward<Args>(args)...); }
+
 		int GetNextFreeNodeIndex() const { return m_NextNodeIndex; }
 		int AddNode(T_NodeType* pNode);
 		void RemoveNode(int node);
@@ -58,6 +67,14 @@ namespace Elite
 		bool IsDirectionalGraph() const { return m_IsDirectionalGraph; }
 		bool IsEmpty() const { return m_Nodes.empty(); }
 
+		// Every change made through the graph ends up here, with a version that goes up with each one
+		const GraphChangeJournal& GetChangeJournal() const { return m_ChangeJournal; }
+
+		// False when no path can exist because the nodes lie in different connected components (weakly connected in a
+		// directional graph). O(1) once the labels caught up with the change journal: added connections merge components,
+		// anything removed relabels the whole graph on the next call. Always true while a GraphOverlay is alive
+		bool AreConnected(int from, int to);
+
 		void Clear();
 		void RemoveConnections();
 
@@ -91,17 +108,44 @@ namespace Elite
 
 		bool m_IsDirectionalGraph;
 
+		GraphChangeJournal m_ChangeJournal{};
+
 		// protected functions
 		bool IsUniqueConnection(int from, int to) const;
 
+		// Lets the next nodes and connections be created in one allocation
+		void ReserveStorage(int nrOfNodes, int nrOfConnections);
+
+		// Batch edits for derived classes that change a lot of the graph at once and call OnGraphModified once afterwards.
+		// They don't raise OnGraphModified or record in the journal and only touch the given direction, also in an undirected graph
+		void BatchAddNode(T_NodeType* pNode);
+		void BatchAddConnection(T_ConnectionType* pConnection);
+		void BatchRemoveConnection(int from, int to);
+
 		// Called whenever the graph is modified, to be overriden by derived classes
 		virtual void OnGraphModified(bool nrOfNodesChanged, bool nrOfConnectionsChanged) {}
 
 	private:
+		// applies and reverts its temporary edits directly on the graph
+		template<class, class> friend class GraphOverlay;
+
 		int m_NextNodeIndex;
 
+		GraphComponents m_Components{};
+		uint64_t m_ComponentsVersion = 0; // version of the change journal the components were labelled for
+		bool m_AreComponentsLabelled = false;
+		int m_NrOfActiveOverlays = 0; // overlays don't record their edits, the labels can't be trusted while one is alive
+		std::vector<GraphChange> m_ComponentChanges{};
+
+		EObjectArena<T_NodeType> m_NodeArena;
+		EObjectArena<T_ConnectionType> m_ConnectionArena;
+
 		// private functions
+		void UpdateComponents();
+		void LabelComponents();
 		void CullInvalidEdges();
+		void DestroyNode(T_NodeType*& pNode);
+		void DestroyConnection(T_ConnectionType*& pConnection);
 	};
 
 	template<class T_NodeType, class T_ConnectionType>
@@ -114,24 +158,17 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline IGraph<T_NodeType, T_ConnectionType>::IGraph(const IGraph& other)
 	{
-		for (auto& n : m_Nodes)
-			SAFE_DELETE(n);
-
-		for (auto& connectionList : m_Connections)
-		{
-			for (auto& connection : connectionList)
-				SAFE_DELETE(connection);
-		};
+		ReserveStorage(other.GetNrOfNodes(), other.GetNrOfConnections());
 
 		for (auto n : other.m_Nodes)
-			m_Nodes.push_back(new T_NodeType(*n));
+			m_Nodes.push_back(CreateNode(*n));
 
-		for (auto cList : other.m_Connections)
+		for (auto& cList : other.m_Connections)
 		{
 			ConnectionList newList;
 			for (auto c : cList)
-				newList.push_back(new T_ConnectionType(*c));
-			m_Connections.push_back(newList);
+				newList.push_back(CreateConnection(*c));
+			m_Connections.push_back(std::move(newList));
 		}
 
 		m_IsDirectionalGraph = other.m_IsDirectionalGraph;
@@ -192,7 +229,7 @@ namespace Elite
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
-	inline const std::list<T_ConnectionType*>& IGraph<T_NodeType, T_ConnectionType>::GetNodeConnections(int idx) const
+	inline const std::vector<T_ConnectionType*>& IGraph<T_NodeType, T_ConnectionType>::GetNodeConnections(int idx) const
 	{
 		assert((idx < (int)m_Nodes.size()) && (idx >= 0) && "<Graph::GetNode>: invalid index");
 
@@ -208,9 +245,12 @@ namespace Elite
 			//a currently active pNode
 			assert(m_Nodes[pNode->GetIndex()]->GetIndex() == invalid_node_index &&
 				"<Graph::AddNode>: Attempting to add a node with a duplicate ID");
+			assert(m_NodeArena.Owns(pNode) && "<Graph::AddNode>: nodes have to be created with CreateNode()");
 
+			DestroyNode(m_Nodes[pNode->GetIndex()]);
 			m_Nodes[pNode->GetIndex()] = pNode;
 
+			m_ChangeJournal.Record(GraphChangeType::NodeAdded, pNode->GetIndex());
 			OnGraphModified(true, false);
 			return m_NextNodeIndex;
 		}
@@ -218,10 +258,12 @@ namespace Elite
 		{
 			//make sure the new pNode has been indexed correctly
 			assert(pNode->GetIndex() == m_NextNodeIndex && "<Graph::AddNode>:invalid index");
+			assert(m_NodeArena.Owns(pNode) && "<Graph::AddNode>: nodes have to be created with CreateNode()");
 
 			m_Nodes.push_back(pNode);
 			m_Connections.push_back(ConnectionList());
 
+			m_ChangeJournal.Record(GraphChangeType::NodeAdded, pNode->GetIndex());
 			OnGraphModified(true, false);
 			return m_NextNodeIndex++;
 		}
@@ -257,10 +299,11 @@ namespace Elite
 					if ((*currentEdgeOnToNode)->GetTo() == node)
 					{
 						hadConnections = true;
+						m_ChangeJournal.Record(GraphChangeType::ConnectionRemoved, (*currentEdgeOnToNode)->GetFrom(), node);
 
 						auto conPtr = *currentEdgeOnToNode;
 						currentEdgeOnToNode = m_Connections[(*currentConnection)->GetTo()].erase(currentEdgeOnToNode);
-						SAFE_DELETE(conPtr);
+						DestroyConnection(conPtr);
 
 						break;
 					}
@@ -272,10 +315,12 @@ namespace Elite
 		for (auto& connection : m_Connections[node])
 		{
 			hadConnections = true;
-			SAFE_DELETE(connection);
+			m_ChangeJournal.Record(GraphChangeType::ConnectionRemoved, node, connection->GetTo());
+			DestroyConnection(connection);
 		}
 		m_Connections[node].clear();
 
+		m_ChangeJournal.Record(GraphChangeType::NodeRemoved, node);
 		OnGraphModified(true, hadConnections);
 	}
 
@@ -285,6 +330,7 @@ namespace Elite
 		//first make sure the from and to nodes exist within the graph 
 		assert((pConnection->GetFrom() < m_NextNodeIndex) && (pConnection->GetTo() < m_NextNodeIndex) && (pConnection->GetTo() != pConnection->GetFrom()) &&
 			"<Graph::AddConnection>: invalid node index");
+		assert(m_ConnectionArena.Owns(pConnection) && "<Graph::AddConnection>: connections have to be created with CreateConnection()");
 
 		//make sure both nodes are active before adding the pConnection
 		if ((m_Nodes[pConnection->GetTo()]->GetIndex() != invalid_node_index) &&
@@ -294,6 +340,7 @@ namespace Elite
 			assert(IsUniqueConnection(pConnection->GetFrom(), pConnection->GetTo()) && "Connection already exists on this graph");
 			
 			m_Connections[pConnection->GetFrom()].push_back(pConnection);
+			m_ChangeJournal.Record(GraphChangeType::ConnectionAdded, pConnection->GetFrom(), pConnection->GetTo());
 
 			//if the graph is undirected we must add another pConnection in the opposite
 			//direction
@@ -302,13 +349,14 @@ namespace Elite
 				//check to make sure the pConnection is unique before adding
 				if (IsUniqueConnection(pConnection->GetTo(), pConnection->GetFrom()))
 				{
-					T_ConnectionType* oppositeDirEdge = new T_ConnectionType();
+					T_ConnectionType* oppositeDirEdge = CreateConnection();
 
 					oppositeDirEdge->SetCost(pConnection->GetCost());
 					oppositeDirEdge->SetTo(pConnection->GetFrom());
 					oppositeDirEdge->SetFrom(pConnection->GetTo());
 
 					m_Connections[pConnection->GetTo()].push_back(oppositeDirEdge);
+					m_ChangeJournal.Record(GraphChangeType::ConnectionAdded, pConnection->GetTo(), pConnection->GetFrom());
 				}
 			}
 		}
@@ -334,6 +382,7 @@ namespace Elite
 				if ((*curEdge)->GetTo() == from) 
 				{ 
 					curEdge = m_Connections[to].erase(curEdge); 
+					m_ChangeJournal.Record(GraphChangeType::ConnectionRemoved, to, from);
 					break; 
 				}
 			}
@@ -346,12 +395,16 @@ namespace Elite
 			if ((*curEdge)->GetTo() == to) 
 			{ 
 				curEdge = m_Connections[from].erase(curEdge); 
+				m_ChangeJournal.Record(GraphChangeType::ConnectionRemoved, from, to);
 				break; 
 			}
 		}
 
-		SAFE_DELETE(conFromTo);
-		SAFE_DELETE(conToFrom);
+		DestroyConnection(conFromTo);
+
+		// in a directional graph the opposite connection is still in use
+		if (!m_IsDirectionalGraph)
+			DestroyConnection(conToFrom);
 
 		OnGraphModified(false, true);
 	}
@@ -366,18 +419,22 @@ namespace Elite
 	inline void IGraph<T_NodeType, T_ConnectionType>::RemoveConnectionsToAdjacentNodes(int idx)
 	{
 		// remove and delete connections from this pNode
-		for (auto c : m_Connections[idx])
-			delete c;
+		for (auto& c : m_Connections[idx])
+		{
+			m_ChangeJournal.Record(GraphChangeType::ConnectionRemoved, idx, c->GetTo());
+			DestroyConnection(c);
+		}
 		m_Connections[idx].clear();
 
 		// remove and delete connections from other nodes to this pNode
 		auto isConnectionToThisNode = [idx](T_ConnectionType* pCon) { return pCon->GetTo() == idx; };
 		for (auto& c : m_Connections)
 		{
-			list<T_ConnectionType*>::iterator foundIt;
+			typename ConnectionList::iterator foundIt;
 			while ((foundIt = std::find_if(c.begin(), c.end(), isConnectionToThisNode))	!= c.end())
 			{
-				delete *foundIt;
+				m_ChangeJournal.Record(GraphChangeType::ConnectionRemoved, (*foundIt)->GetFrom(), idx);
+				DestroyConnection(*foundIt);
 				c.erase(foundIt);
 			}
 		}
@@ -397,9 +454,13 @@ namespace Elite
 			curEdge != m_Connections[from].end();
 			++curEdge)
 		{
-			if (curEdge->GetTo() == to)
+			if ((*curEdge)->GetTo() == to)
 			{
-				curEdge->SetCost(cost);
+				if ((*curEdge)->GetCost() != cost)
+				{
+					(*curEdge)->SetCost(cost);
+					m_ChangeJournal.Record(GraphChangeType::ConnectionCostChanged, from, to);
+				}
 				break;
 			}
 		}
@@ -435,25 +496,40 @@ namespace Elite
 	template<class T_NodeType, class T_ConnectionType>
 	inline void IGraph<T_NodeType, T_ConnectionType>::Clear()
 	{
-		for (auto& n : m_Nodes)
-			SAFE_DELETE(n);
+		// the arenas free their memory in one go, only objects with a destructor need to be visited
+		if (!std::is_trivially_destructible<T_NodeType>::value)
+		{
+			for (auto& n : m_Nodes)
+				DestroyNode(n);
+		}
 		m_Nodes.clear();
+		m_NodeArena.Release();
 
-		for (auto& connectionList : m_Connections)
+		if (!std::is_trivially_destructible<T_ConnectionType>::value)
 		{
-			for (auto& connection : connectionList)
-				SAFE_DELETE(connection);
+			for (auto& connectionList : m_Connections)
+			{
+				for (auto& connection : connectionList)
+					DestroyConnection(connection);
+			}
 		}
 		m_Connections.clear();
+		m_ConnectionArena.Release();
 
 		m_NextNodeIndex = 0;
+		m_ChangeJournal.RecordReset();
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
 	inline void IGraph<T_NodeType, T_ConnectionType>::RemoveConnections()
 	{
 		for (auto& connectionList : m_Connections)
+		{
+			for (auto& connection : connectionList)
+				DestroyConnection(connection);
 			connectionList.clear();
+		}
+		m_ChangeJournal.RecordReset();
 	}
 
 	template<class T_NodeType, class T_ConnectionType>
@@ -485,6 +561,20 @@ namespace Elite
 		return  DEFAULT_NODE_COLOR;
 	}
 
+	template<>
+	inline Elite::Color IGraph<CompactGridNode, CompactGraphConnection>::GetNodeColor(CompactGridNode* pNode) const
+	{
+		switch (pNode->GetTerrainType())
+		{
+			case TerrainType::Mud:
+				return MUD_NODE_COLOR;
+			case TerrainType::Water:
+				return WATER_NODE_COLOR;
+		}
+
+		return DEFAULT_NODE_COLOR;
+	}
+
 	template<class T_NodeType, class T_ConnectionType>
 	inline Elite::Color IGraph<T_NodeType, T_ConnectionType>::GetConnectionColor(T_ConnectionType* pNode) const
 	{
@@ -518,6 +608,122 @@ namespace Elite
 		return true;
 	}
 
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::ReserveStorage(int nrOfNodes, int nrOfConnections)
+	{
+		m_NodeArena.Reserve(nrOfNodes);
+		m_ConnectionArena.Reserve(nrOfConnections);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::BatchAddNode(T_NodeType* pNode)
+	{
+		assert(pNode->GetIndex() == m_NextNodeIndex && "<Graph::BatchAddNode>:invalid index");
+		assert(m_NodeArena.Owns(pNode) && "<Graph::BatchAddNode>: nodes have to be created with CreateNode()");
+
+		m_Nodes.push_back(pNode);
+		m_Connections.push_back(ConnectionList());
+		++m_NextNodeIndex;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::BatchAddConnection(T_ConnectionType* pConnection)
+	{
+		assert((pConnection->GetFrom() < m_NextNodeIndex) && (pConnection->GetTo() < m_NextNodeIndex) && (pConnection->GetTo() != pConnection->GetFrom()) &&
+			"<Graph::BatchAddConnection>: invalid node index");
+		assert(m_ConnectionArena.Owns(pConnection) && "<Graph::BatchAddConnection>: connections have to be created with CreateConnection()");
+		assert(IsUniqueConnection(pConnection->GetFrom(), pConnection->GetTo()) && "Connection already exists on this graph");
+
+		m_Connections[pConnection->GetFrom()].push_back(pConnection);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::BatchRemoveConnection(int from, int to)
+	{
+		auto& connections = m_Connections[from];
+		for (auto it = connections.begin(); it != connections.end(); ++it)
+		{
+			if ((*it)->GetTo() == to)
+			{
+				auto pConnection = *it;
+				connections.erase(it);
+				DestroyConnection(pConnection);
+				return;
+			}
+		}
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline bool IGraph<T_NodeType, T_ConnectionType>::AreConnected(int from, int to)
+	{
+		if (from == to || m_NrOfActiveOverlays > 0)
+			return true;
+
+		UpdateComponents();
+		return m_Components.Find(from) == m_Components.Find(to);
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::UpdateComponents()
+	{
+		if (m_AreComponentsLabelled && m_ComponentsVersion == m_ChangeJournal.GetVersion())
+			return;
+
+		m_ComponentChanges.clear();
+		if (!m_AreComponentsLabelled || !m_ChangeJournal.GetChangesSince(m_ComponentsVersion, m_ComponentChanges))
+		{
+			LabelComponents();
+			return;
+		}
+
+		// only additions can be applied on top of the labels, a component that got split has to be labelled again
+		m_Components.Resize(int(m_Nodes.size()));
+		for (const GraphChange& change : m_ComponentChanges)
+		{
+			switch (change.type)
+			{
+			case GraphChangeType::ConnectionAdded:
+				m_Components.Merge(change.from, change.to);
+				break;
+			case GraphChangeType::ConnectionRemoved:
+			case GraphChangeType::NodeRemoved:
+				LabelComponents();
+				return;
+			default:
+				break;
+			}
+		}
+		m_ComponentsVersion = m_ChangeJournal.GetVersion();
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::LabelComponents()
+	{
+		m_Components.Reset(int(m_Nodes.size()));
+		for (const auto& connectionList : m_Connections)
+		{
+			for (const auto pConnection : connectionList)
+				m_Components.Merge(pConnection->GetFrom(), pConnection->GetTo());
+		}
+
+		m_ComponentsVersion = m_ChangeJournal.GetVersion();
+		m_AreComponentsLabelled = true;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::DestroyNode(T_NodeType*& pNode)
+	{
+		m_NodeArena.Destroy(pNode);
+		pNode = nullptr;
+	}
+
+	template<class T_NodeType, class T_ConnectionType>
+	inline void IGraph<T_NodeType, T_ConnectionType>::DestroyConnection(T_ConnectionType*& pConnection)
+	{
+		m_ConnectionArena.Destroy(pConnection);
+		pConnection = nullptr;
+	}
+
 	template<class T_NodeType, class T_ConnectionType>
 	inline void IGraph<T_NodeType, T_ConnectionType>::CullInvalidEdges()
 	{
@@ -4,45 +4,112 @@
 
 using namespace Elite;
 
-Elite::NavGraph::NavGraph(const Polygon& contourMesh, float playerRadius = 1.0f) :
+Elite::NavGraph::NavGraph(const Polygon& contourMesh, float playerRadius = 1.0f, float tileSize) :
 	Graph2D(false),
-	m_pNavMeshPolygon(nullptr)
+	m_pNavMeshPolygon(nullptr),
+	m_TileSize(tileSize),
+	m_PlayerRadius(playerRadius)
 {
 	//Create the navigation mesh (polygon of navigatable area= Contour - Static Shapes)
 	m_pNavMeshPolygon = new Polygon(contourMesh); // Create copy on heap
+	m_pNavMeshTiles = new NavMeshTiles(contourMesh, tileSize);
 
+	//Triangulate and create the actual graph (nodes & connections) from the navigation mesh
+	UpdateNavigationMesh();
+}
+
+Elite::NavGraph::~NavGraph()
+{
+	delete m_pNavMeshPolygon;
+	m_pNavMeshPolygon = nullptr;
+	delete m_pNavMeshTiles;
+	m_pNavMeshTiles = nullptr;
+}
+
+int Elite::NavGraph::UpdateNavigationMesh()
+{
 	//Get all shapes from all static rigidbodies with NavigationCollider flag
 	auto vShapes = PHYSICSWORLD->GetAllStaticShapesInWorld(PhysicsFlags::NavigationCollider);
+	for (auto& shape : vShapes)
+		shape.ExpandShape(m_PlayerRadius);
 
-	//Store all children
-	for (auto shape : vShapes)
+	//After a load the tiles catch up with the loaded obstacles first, so they don't mix in tiles of the previous mesh
+	if (m_AreTilesOutdated)
 	{
-		shape.ExpandShape(playerRadius);
-		m_pNavMeshPolygon->AddChild(shape);
+		m_pNavMeshTiles->Update(m_vObstacles);
+		m_AreTilesOutdated = false;
 	}
 
-	//Triangulate
-	m_pNavMeshPolygon->Triangulate();
+	//Only the tiles where the obstacles changed get triangulated again
+	const int nrOfRebuiltTiles{ m_pNavMeshTiles->Update(vShapes) };
+	if (nrOfRebuiltTiles == 0)
+		return 0;
 
-	//Create the actual graph (nodes & connections) from the navigation mesh
+	//Store all children
+	for (const auto& obstacle : m_vObstacles)
+		m_pNavMeshPolygon->RemoveChild(obstacle);
+	for (const auto& shape : vShapes)
+		m_pNavMeshPolygon->AddChild(shape);
+	m_vObstacles = std::move(vShapes);
+
+	//The tiles are stitched together by the line matrix of the polygon, the graph is made again from those lines
+	m_pNavMeshPolygon->SetTriangles(m_pNavMeshTiles->GetTriangles());
+	Clear();
 	CreateNavigationGraph();
+	return nrOfRebuiltTiles;
 }
 
-Elite::NavGraph::~NavGraph()
+void Elite::NavGraph::Save(BinaryFileWriter& file) const
 {
-	delete m_pNavMeshPolygon;
-	m_pNavMeshPolygon = nullptr;
+	m_pNavMeshPolygon->Save(file);
 }
 
-int Elite::NavGraph::GetNodeIdxFromLineIdx(int lineIdx) const
+bool Elite::NavGraph::Load(const BinaryFileView& file)
 {
-	auto nodeIt = std::find_if(m_Nodes.begin(), m_Nodes.end(), [lineIdx](const NavGraphNode* n) { return n->GetLineIndex() == lineIdx; });
-	if (nodeIt != m_Nodes.end())
+	//Children that aren't obstacles are holes of the contour, those stay when the obstacles change
+	std::vector<Polygon> contourHoles;
+	for (const auto& child : m_pNavMeshPolygon->GetChildren())
+	{
+		if (std::find(m_vObstacles.begin(), m_vObstacles.end(), child) == m_vObstacles.end())
+			contourHoles.push_back(child);
+	}
+
+	if (!m_pNavMeshPolygon->Load(file))
+		return false;
+
+	m_vObstacles.clear();
+	std::vector<std::vector<Vector2>> loadedHoles;
+	for (const auto& child : m_pNavMeshPolygon->GetChildren())
 	{
-		return (*nodeIt)->GetIndex();
+		if (std::find(contourHoles.begin(), contourHoles.end(), child) == contourHoles.end())
+			m_vObstacles.push_back(child);
+		else
+			loadedHoles.emplace_back(child.GetPoints().begin(), child.GetPoints().end());
 	}
 
-	return invalid_node_index;
+	//The tiles start over from the loaded contour. They're only triangulated once the obstacles change,
+	//so loading stays as cheap as it was
+	const std::vector<Vector2> loadedContour(m_pNavMeshPolygon->GetPoints().begin(), m_pNavMeshPolygon->GetPoints().end());
+	delete m_pNavMeshTiles;
+	m_pNavMeshTiles = new NavMeshTiles(Polygon(loadedContour, loadedHoles), m_TileSize);
+	m_AreTilesOutdated = true;
+
+	Clear();
+	CreateNavigationGraph();
+	return true;
+}
+
+int Elite::NavGraph::GetNodeIdxFromLineIdx(int lineIdx) const
+{
+	if (lineIdx < 0 || lineIdx >= int(m_NodeIdxFromLineIdx.size()))
+		return invalid_node_index;
+
+	//The node might have been removed from the graph since
+	const int nodeIdx{ m_NodeIdxFromLineIdx[lineIdx] };
+	if (nodeIdx == invalid_node_index || m_Nodes[nodeIdx]->GetIndex() == invalid_node_index)
+		return invalid_node_index;
+
+	return nodeIdx;
 }
 
 Elite::Polygon* Elite::NavGraph::GetNavMeshPolygon() const
@@ -54,6 +121,7 @@ void Elite::NavGraph::CreateNavigationGraph()
 {
 	//1. Go over all the edges of the navigationmesh and create nodes
 	const auto& edges{ m_pNavMeshPolygon->GetLines() };
+	m_NodeIdxFromLineIdx.assign(edges.size(), invalid_node_index);
 	for (const auto& line : edges)
 	{
 		const auto adjacentTriangles{
@@ -65,7 +133,8 @@ void Elite::NavGraph::CreateNavigationGraph()
 			// must create a node
 			const Vector2 vec{ (line->p2 + line->p1) / 2 };
 
-			AddNode(new NavGraphNode(
+			m_NodeIdxFromLineIdx[line->index] = GetNextFreeNodeIndex();
+			AddNode(CreateNode(
 				GetNextFreeNodeIndex(),
 				line->index,
 				vec
@@ -104,7 +173,7 @@ void Elite::NavGraph::CreateNavigationGraph()
 				int nextValidNodeIdx{ (i + 1) % maximumNodeInTriangle };
 				if(validNodeIdxs[nextValidNodeIdx] != invalid_node_index)
 				{
-					AddConnection(new GraphConnection2D(
+					AddConnection(CreateConnection(
 						validNodeIdxs[i],
 						validNodeIdxs[nextValidNodeIdx]
 					));
@@ -3,21 +3,37 @@
 #include "framework/EliteAI/EliteGraphs/EGraph2D.h"
 #include "framework/EliteAI/EliteGraphs/EGraphConnectionTypes.h"
 #include "framework/EliteAI/EliteGraphs/EGraphNodeTypes.h"
+#include "framework/EliteAI/EliteNavigation/ENavMeshTiles.h"
 
 namespace Elite
 {
 	class NavGraph final: public Graph2D<NavGraphNode, GraphConnection2D>
 	{
 	public:
-		NavGraph(const Polygon& baseMesh, float playerRadius );
+		//The mesh is cut in tiles of tileSize, only the tiles overlapping a changed obstacle are triangulated again.
+		//A tile size of 0 triangulates the whole mesh at once
+		NavGraph(const Polygon& baseMesh, float playerRadius, float tileSize = 0.f);
 		~NavGraph();
 
+		//Picks up added, moved and removed NavigationColliders, returns the amount of tiles that got triangulated again
+		int UpdateNavigationMesh();
+
+		//Saves the triangulated navigation mesh, Load replaces it and makes the graph again from it
+		void Save(BinaryFileWriter& file) const;
+		bool Load(const BinaryFileView& file);
+
 		int GetNodeIdxFromLineIdx(int lineIdx) const;
 		Polygon* GetNavMeshPolygon() const;
 
 	private:
 		//--- Datamembers ---
 		Polygon* m_pNavMeshPolygon = nullptr; //Polygon that represents navigation mesh
+		NavMeshTiles* m_pNavMeshTiles = nullptr; //Triangulation of the navigation mesh per tile
+		float m_TileSize = 0.f;
+		bool m_AreTilesOutdated = false; //The mesh got loaded, the tiles haven't been triangulated for it yet
+		std::vector<Polygon> m_vObstacles{}; //Expanded shapes of the NavigationColliders, children of the navigation mesh
+		float m_PlayerRadius = 1.f;
+		std::vector<int> m_NodeIdxFromLineIdx{}; //Node on every line of the navigation mesh, invalid_node_index if there is none
 
 		void CreateNavigationGraph();
 
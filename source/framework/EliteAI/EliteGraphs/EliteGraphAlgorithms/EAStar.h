@@ -32,11 +32,24 @@ namespace Elite
 			}
 		};
 
-		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		// isFallingBackToClosest: when the goal can't be reached (e.g. it is water), returns the path to the reached node
+		// that is closest to the goal by the heuristic, instead of only the start node
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode, bool isFallingBackToClosest = false);
+		// one search towards whichever goal is the cheapest to reach, instead of a FindPath per goal.
+		// The h-cost is the smallest one over all goals so it stays admissible, the fallback heads for the node closest to any goal
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, const std::vector<T_NodeType*>& goalNodes, bool isFallingBackToClosest = false);
 		std::vector<NodeForRender> GetVisitedNodeIdx();
 
 	private:
 		float GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const;
+		float GetHeuristicCost(T_NodeType* pNode, const std::vector<T_NodeType*>& goalNodes) const;
+
+		// follows the connections back to the start, a node that got reopened can still be in the open list
+		std::vector<T_NodeType*> ReconstructPath(
+			NodeRecord record,
+			T_NodeType* pStartNode,
+			const std::vector<NodeRecord>& closeList,
+			const std::vector<NodeRecord>& openList) const;
 
 		std::vector<NodeRecord> m_CloseList;
 		IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
@@ -51,23 +64,59 @@ namespace Elite
 	}
 
 	template <class T_NodeType, class T_ConnectionType>
-	std::vector<T_NodeType*> AStar<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pGoalNode)
+	std::vector<T_NodeType*> AStar<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, T_NodeType* pGoalNode, bool isFallingBackToClosest)
+	{
+		return FindPath(pStartNode, std::vector<T_NodeType*>{ pGoalNode }, isFallingBackToClosest);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> AStar<T_NodeType, T_ConnectionType>::FindPath(T_NodeType* pStartNode, const std::vector<T_NodeType*>& goalNodes, bool isFallingBackToClosest)
 	{
 		m_CloseList.clear();
 
-		if (pStartNode != pGoalNode)
+		// nodes in different components can't be connected, no need to flood the reachable area to find that out.
+		// The fallback has to look at everything that is reachable anyway
+		std::vector<T_NodeType*> reachableGoals{};
+		for (T_NodeType* pGoalNode : goalNodes)
 		{
+			if (pGoalNode == pStartNode)
+				return vector<T_NodeType*>{pStartNode};
+
+			if (isFallingBackToClosest || m_pGraph->AreConnected(pStartNode->GetIndex(), pGoalNode->GetIndex()))
+				reachableGoals.emplace_back(pGoalNode);
+		}
+
+		if (!reachableGoals.empty())
+		{
+			std::vector<bool> isGoal(m_pGraph->GetNrOfNodes(), false);
+			for (T_NodeType* pGoalNode : reachableGoals)
+				isGoal[pGoalNode->GetIndex()] = true;
+
+			// the h-cost goes over every goal, so it's worked out once per node instead of every time the node is reached
+			std::vector<float> hCosts(m_pGraph->GetNrOfNodes(), -1.f);
+			auto getHeuristicCost{ [this, &hCosts, &reachableGoals](T_NodeType* pNode)
+			{
+				float& hCost{ hCosts[pNode->GetIndex()] };
+				if (hCost < 0.f)
+					hCost = GetHeuristicCost(pNode, reachableGoals);
+				return hCost;
+			} };
+
 			std::vector<NodeRecord> openList{};
 			std::vector<NodeRecord> closeList{};
 
 			NodeRecord start{};
 			start.pNode = pStartNode;
-			start.estimatedTotalCost = GetHeuristicCost(pStartNode, pGoalNode);
+			start.estimatedTotalCost = getHeuristicCost(pStartNode);
 
 			openList.emplace_back(start);
 			typename std::vector<NodeRecord>::iterator shortestNodeRecIt{};
 			NodeRecord currentNodeRec{};
 
+			// closest to the goal by heuristic of all closed nodes, ties go to the cheapest one
+			NodeRecord closestNodeRec{ start };
+			float closestHCost{ start.estimatedTotalCost };
+
 #pragma region First Style
 			/*
 			while(!openList.empty())
@@ -165,7 +214,17 @@ namespace Elite
 				openList.erase(cIt);
 				closeList.emplace_back(currentNodeRec);
 
-				if (currentNodeRec.pNode != pGoalNode)
+				if (isFallingBackToClosest)
+				{
+					const float hCost{ getHeuristicCost(currentNodeRec.pNode) };
+					if (hCost < closestHCost || (hCost == closestHCost && currentNodeRec.costSoFar < closestNodeRec.costSoFar))
+					{
+						closestNodeRec = currentNodeRec;
+						closestHCost = hCost;
+					}
+				}
+
+				if (!isGoal[currentNodeRec.pNode->GetIndex()])
 				{
 					const auto& neighbours{ m_pGraph->GetNodeConnections(currentNodeRec.pNode->GetIndex()) };
 					for (const auto& connection : neighbours)
@@ -177,7 +236,7 @@ namespace Elite
 							const float costSoFar{ currentNodeRec.costSoFar /*+ GetHeuristicCost(currentNodeRec.pNode,pointedNode)*/ + connection->GetCost() };
 
 							// TODO: This one might cause problem because it doesn't take connection cost into account
-							const float connectionFCost{ costSoFar + GetHeuristicCost(pointedNode,pGoalNode) };
+							const float connectionFCost{ costSoFar + getHeuristicCost(pointedNode) };
 	
 							auto fIt = std::find_if(closeList.begin(), closeList.end(),
 								[&pointedNode](const NodeRecord& rec)
@@ -185,11 +244,12 @@ namespace Elite
 									return rec.pNode == pointedNode;
 								});
 
+							// a cheaper path reopens the node, otherwise it's already taken care of
 							if (fIt != closeList.end())
 							{
-								if (costSoFar < fIt->costSoFar)
-									closeList.erase(fIt);
-								continue;
+								if (costSoFar >= fIt->costSoFar)
+									continue;
+								closeList.erase(fIt);
 							}
 
 							fIt = std::find_if(openList.begin(), openList.end(),
@@ -200,9 +260,9 @@ namespace Elite
 
 							if (fIt != openList.end())
 							{
-								if (costSoFar < fIt->costSoFar)
-									openList.erase(fIt);
-								continue;
+								if (costSoFar >= fIt->costSoFar)
+									continue;
+								openList.erase(fIt);
 							}
 							
 							NodeRecord traverseNode{
@@ -218,32 +278,59 @@ namespace Elite
 				}
 				else
 				{
-					std::vector<T_NodeType*> path{};
-					while (currentNodeRec.pNode != pStartNode)
-					{
-						path.emplace_back(currentNodeRec.pNode);
-						T_NodeType* connectedNode{ m_pGraph->GetNode(currentNodeRec.pConnection->GetFrom()) };
-						currentNodeRec = *std::find_if(closeList.begin(), closeList.end(),
-							[&connectedNode](const NodeRecord& rec)
-							{
-								return rec.pNode == connectedNode;
-							});
-					}
-
-					path.emplace_back(pStartNode);
-					std::reverse(path.begin(), path.end());
-
+					std::vector<T_NodeType*> path{ ReconstructPath(currentNodeRec, pStartNode, closeList, openList) };
 					m_CloseList = std::move(closeList);
 
 					return path;
 				}
 			}
 
+			// everything reachable got closed without meeting a goal
+			if (isFallingBackToClosest)
+			{
+				std::vector<T_NodeType*> path{ ReconstructPath(closestNodeRec, pStartNode, closeList, openList) };
+				m_CloseList = std::move(closeList);
+
+				return path;
+			}
 		}
 
 		return vector<T_NodeType*>{pStartNode};
 	}
 
+	template <class T_NodeType, class T_ConnectionType>
+	std::vector<T_NodeType*> AStar<T_NodeType, T_ConnectionType>::ReconstructPath(
+		NodeRecord record,
+		T_NodeType* pStartNode,
+		const std::vector<NodeRecord>& closeList,
+		const std::vector<NodeRecord>& openList) const
+	{
+		std::vector<T_NodeType*> path{};
+		while (record.pNode != pStartNode)
+		{
+			// the chain back to the start is broken, treat it as no path
+			if (!record.pConnection)
+				return vector<T_NodeType*>{pStartNode};
+
+			path.emplace_back(record.pNode);
+			T_NodeType* connectedNode{ m_pGraph->GetNode(record.pConnection->GetFrom()) };
+			auto isConnectedNode{ [&connectedNode](const NodeRecord& rec) { return rec.pNode == connectedNode; } };
+
+			auto it{ std::find_if(closeList.begin(), closeList.end(), isConnectedNode) };
+			if (it == closeList.end())
+			{
+				it = std::find_if(openList.begin(), openList.end(), isConnectedNode);
+				if (it == openList.end())
+					return vector<T_NodeType*>{pStartNode};
+			}
+			record = *it;
+		}
+
+		path.emplace_back(pStartNode);
+		std::reverse(path.begin(), path.end());
+		return path;
+	}
+
 	template <class T_NodeType, class T_ConnectionType>
 	std::vector<NodeForRender> AStar<T_NodeType, T_ConnectionType>::GetVisitedNodeIdx()
 	{
@@ -267,4 +354,14 @@ namespace Elite
 		Vector2 toDestination = m_pGraph->GetNodePos(pEndNode) - m_pGraph->GetNodePos(pStartNode);
 		return m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y));
 	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	float Elite::AStar<T_NodeType, T_ConnectionType>::GetHeuristicCost(T_NodeType* pNode, const std::vector<T_NodeType*>& goalNodes) const
+	{
+		float hCost{ FLT_MAX };
+		for (T_NodeType* pGoalNode : goalNodes)
+			hCost = std::min(hCost, GetHeuristicCost(pNode, pGoalNode));
+
+		return hCost;
+	}
 }
@@ -0,0 +1,171 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EDijkstra.h: Dijkstra from one node to every node of a graph, and a table of the costs between every pair of
+// a chosen set of nodes built on top of it. For when all costs are needed instead of one path.
+/*=============================================================================*/
+#pragma once
+#include <cfloat>
+#include <queue>
+#include "framework/EliteHelpers/EBinaryFile.h"
+#include "framework/EliteHelpers/EParallel.h"
+
+namespace Elite
+{
+	// Only reads the graph, so searches from different threads are fine as long as nobody edits the graph meanwhile
+	template <class T_NodeType, class T_ConnectionType>
+	class Dijkstra
+	{
+	public:
+		explicit Dijkstra(IGraph<T_NodeType, T_ConnectionType>* pGraph);
+
+		// costs[idx] is the cheapest cost from the start to node idx, FLT_MAX when it can't be reached.
+		// parents[idx] is the node before idx on that path, invalid_node_index for the start and unreached nodes
+		void FindCosts(int startIdx, std::vector<float>& costs) const;
+		void FindCosts(int startIdx, std::vector<float>& costs, std::vector<int>& parents) const;
+
+	private:
+		void FindCosts(int startIdx, std::vector<float>& costs, std::vector<int>* pParents) const;
+
+		IGraph<T_NodeType, T_ConnectionType>* m_pGraph;
+	};
+
+	// Cheapest costs between every pair of a chosen set of nodes (points of interest), meant to be baked offline and
+	// loaded with the level. Entries are indexed by the position of the node in GetNodeIndices(), not by node index
+	class DistanceTable final
+	{
+	public:
+		// one Dijkstra per source node, the sources are spread over the default task pool
+		template <class T_NodeType, class T_ConnectionType>
+		void Build(IGraph<T_NodeType, T_ConnectionType>* pGraph, const std::vector<int>& nodeIndices, const ProgressCallback& progress = nullptr);
+
+		const std::vector<int>& GetNodeIndices() const { return m_NodeIndices; }
+		int GetSize() const { return static_cast<int>(m_NodeIndices.size()); }
+
+		// position of the node in GetNodeIndices(), -1 when it isn't part of the table
+		int GetPosition(int nodeIdx) const;
+
+		// FLT_MAX when there is no path
+		float GetCost(int fromPosition, int toPosition) const { return m_Costs[fromPosition * m_NodeIndices.size() + toPosition]; }
+
+		void Save(BinaryFileWriter& file) const;
+		// false when the file holds no table
+		bool Load(const BinaryFileView& file);
+
+	private:
+		static constexpr uint32_t FileNodesId = CompileTimeLiteralStringHash("DistanceTableNodes");
+		static constexpr uint32_t FileCostsId = CompileTimeLiteralStringHash("DistanceTableCosts");
+
+		std::vector<int> m_NodeIndices{};
+		std::vector<float> m_Costs{}; // row major, a row per source
+	};
+
+	template <class T_NodeType, class T_ConnectionType>
+	Dijkstra<T_NodeType, T_ConnectionType>::Dijkstra(IGraph<T_NodeType, T_ConnectionType>* pGraph)
+		: m_pGraph(pGraph)
+	{
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void Dijkstra<T_NodeType, T_ConnectionType>::FindCosts(int startIdx, std::vector<float>& costs) const
+	{
+		FindCosts(startIdx, costs, nullptr);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void Dijkstra<T_NodeType, T_ConnectionType>::FindCosts(int startIdx, std::vector<float>& costs, std::vector<int>& parents) const
+	{
+		FindCosts(startIdx, costs, &parents);
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void Dijkstra<T_NodeType, T_ConnectionType>::FindCosts(int startIdx, std::vector<float>& costs, std::vector<int>* pParents) const
+	{
+		costs.assign(m_pGraph->GetNrOfNodes(), FLT_MAX);
+		if (pParents)
+			pParents->assign(m_pGraph->GetNrOfNodes(), invalid_node_index);
+
+		if (!m_pGraph->IsNodeValid(startIdx))
+			return;
+
+		// an entry is outdated once the node got a cheaper cost, those are skipped instead of updated in place
+		using OpenEntry = std::pair<float, int>;
+		std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> openList{};
+
+		costs[startIdx] = 0.f;
+		openList.emplace(0.f, startIdx);
+
+		while (!openList.empty())
+		{
+			const OpenEntry current = openList.top();
+			openList.pop();
+
+			if (current.first > costs[current.second])
+				continue;
+
+			for (const auto& connection : m_pGraph->GetNodeConnections(current.second))
+			{
+				if (!connection->IsValid())
+					continue;
+
+				const int toIdx = connection->GetTo();
+				const float costSoFar = current.first + connection->GetCost();
+				if (costSoFar >= costs[toIdx])
+					continue;
+
+				costs[toIdx] = costSoFar;
+				if (pParents)
+					(*pParents)[toIdx] = current.second;
+				openList.emplace(costSoFar, toIdx);
+			}
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType>
+	void DistanceTable::Build(IGraph<T_NodeType, T_ConnectionType>* pGraph, const std::vector<int>& nodeIndices, const ProgressCallback& progress)
+	{
+		m_NodeIndices = nodeIndices;
+		m_Costs.assign(nodeIndices.size() * nodeIndices.size(), FLT_MAX);
+
+		// every source writes its own row
+		const Dijkstra<T_NodeType, T_ConnectionType> dijkstra{ pGraph };
+		ParallelFor(0, GetSize(), 1, [this, pGraph, &dijkstra](int firstSource, int lastSource)
+		{
+			std::vector<float> costs{};
+			for (int from = firstSource; from < lastSource; ++from)
+			{
+				dijkstra.FindCosts(m_NodeIndices[from], costs);
+				for (size_t to = 0; to < m_NodeIndices.size(); ++to)
+				{
+					if (pGraph->IsNodeValid(m_NodeIndices[to]))
+						m_Costs[from * m_NodeIndices.size() + to] = costs[m_NodeIndices[to]];
+				}
+			}
+		}, progress);
+	}
+
+	inline int DistanceTable::GetPosition(int nodeIdx) const
+	{
+		const auto it = std::find(m_NodeIndices.begin(), m_NodeIndices.end(), nodeIdx);
+		return it != m_NodeIndices.end() ? static_cast<int>(it - m_NodeIndices.begin()) : -1;
+	}
+
+	inline void DistanceTable::Save(BinaryFileWriter& file) const
+	{
+		file.AddSection(FileNodesId, m_NodeIndices);
+		file.AddSection(FileCostsId, m_Costs);
+	}
+
+	inline bool DistanceTable::Load(const BinaryFileView& file)
+	{
+		size_t nrOfNodes = 0, nrOfCosts = 0;
+		const int* pNodes = file.GetSection<int>(FileNodesId, nrOfNodes);
+		const float* pCosts = file.GetSection<float>(FileCostsId, nrOfCosts);
+		if (!pNodes || !pCosts || nrOfCosts != nrOfNodes * nrOfNodes)
+			return false;
+
+		m_NodeIndices.assign(pNodes, pNodes + nrOfNodes);
+		m_Costs.assign(pCosts, pCosts + nrOfCosts);
+		return true;
+	}
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include <stack>
+#include "framework/EliteAI/EliteGraphs/EGraphOverlay.h"
 
 namespace Elite
 {
@@ -68,38 +69,36 @@ namespace Elite
 		if (!IsConnected())
 			return {};
 
-		// Get a copy of the graph because this algorithm involves removing edges
-		auto graphCopy = m_pGraph->Clone();
-		int nrOfNodes = graphCopy->GetNrOfNodes();
+		// This algorithm involves removing nodes, hide them in an overlay that restores the graph afterwards
+		GraphOverlay<T_NodeType, T_ConnectionType> overlay{ m_pGraph };
+		int nrOfNodes = m_pGraph->GetNrOfNodes();
 		std::vector<T_NodeType*> path{};
 
 		// algorithm...
 
-		auto generatePath{ [](
-			const std::shared_ptr<IGraph<T_NodeType,T_ConnectionType>>& graphClone,
-			int startNode)
+		auto generatePath{ [this, &overlay](int startNode)
 		{
 			std::vector<T_NodeType*> genPath;
 			int currentTraverseIndex = startNode;
 
-			genPath.emplace_back(graphClone->GetNode(startNode));
+			genPath.emplace_back(m_pGraph->GetNode(startNode));
 			
-			while (!graphClone->GetNodeConnections(currentTraverseIndex).empty() &&
-					!graphClone->IsEmpty())
+			while (!m_pGraph->GetNodeConnections(currentTraverseIndex).empty() &&
+					!m_pGraph->IsEmpty())
 			{
-				auto traverseConnections{ graphClone->GetNodeConnections(currentTraverseIndex) };
+				auto traverseConnections{ m_pGraph->GetNodeConnections(currentTraverseIndex) };
 				for (int i = 0; i < int(traverseConnections.size()); ++i)
 				{
 					int nextIndex{ traverseConnections.front()->GetTo() };
-					if (graphClone->IsNodeValid(nextIndex))
+					if (m_pGraph->IsNodeValid(nextIndex))
 					{
-						genPath.emplace_back(graphClone->GetNode(nextIndex));
+						genPath.emplace_back(m_pGraph->GetNode(nextIndex));
 						currentTraverseIndex = i;
 						break;
 					}
 				}
 
-				graphClone->RemoveNode(currentTraverseIndex);
+				overlay.HideNode(currentTraverseIndex);
 			}
 
 			return genPath;
@@ -120,7 +119,7 @@ namespace Elite
 				}
 			}
 
-			path = generatePath(graphCopy, startIndex);
+			path = generatePath(startIndex);
 		}
 
 		else if (eulerianity == Eulerianity::eulerian)
@@ -131,7 +130,7 @@ namespace Elite
 			if(m_pGraph->IsNodeValid(firstActiveIndex))
 				startIndex = firstActiveIndex;
 			
-			path = generatePath(graphCopy, startIndex);
+			path = generatePath(startIndex);
 		}
 
 		return path;
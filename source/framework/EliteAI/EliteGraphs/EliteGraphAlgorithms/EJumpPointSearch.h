@@ -9,7 +9,10 @@
 
 #include "projects/Helpers.h"
 
-template<typename T_NodeType, typename T_ConnectionType>
+// T_MovementPolicy decides the pruning rules, it should match the policy the grid graph was built with
+// Symmetry pruning only holds on uniform costs, a terrain aware search stops its jumps at every terrain boundary
+// and searches all directions from there, so grids with different terrain costs still get optimal paths
+template<typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy = Elite::AllowCornerCutting>
 class JumpPointSearch
 {
 public:
@@ -18,7 +21,8 @@ public:
 		Elite::IGraph<T_NodeType, T_ConnectionType>* pGraph,
 		Elite::Heuristic pHeuristicFunc,
 		int graphColCount,
-		int graphRowCount);
+		int graphRowCount,
+		bool isTerrainAware = false);
 
 	enum class Direction
 	{
@@ -36,15 +40,15 @@ public:
 	struct NodeRecord
 	{
 		T_NodeType* pNode = nullptr;
-		T_ConnectionType* pConnection = nullptr;
-		Direction parentDirection = Direction::None;
+		T_NodeType* pParent = nullptr; // jump point we jumped from to get here
+		Direction parentDirection = Direction::None; // direction of the jump that found this node
 		float gCost{};
 		float hCost{};
 
 		bool operator==(const NodeRecord& other) const
 		{
 			return pNode == other.pNode
-				&& pConnection == other.pConnection
+				&& pParent == other.pParent
 				&& gCost == other.gCost
 				&& hCost == other.hCost;
 		}
@@ -58,7 +62,10 @@ public:
 
 
 	// Utilities
-	std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pEndNode);
+	// isJumpPointsOnly skips the cells in between the jump points, which are connected by straight or diagonal lines
+	// isFallingBackToClosest: when the goal can't be reached (e.g. it is water), returns the path to the cell closest to
+	// the goal by the heuristic out of all cells the jumps passed, instead of only the start node
+	std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pEndNode, bool isJumpPointsOnly = false, bool isFallingBackToClosest = false);
 	std::vector<NodeForRender> GetJumpPoints();
 
 	// For Debugging
@@ -75,46 +82,82 @@ private:
 	// Debugging
 	std::vector<SearchDirection> m_SearchDirections;
 
+	// Fallback bookkeeping, every cell a jump passes is reachable from the jump point the jump started from
+	struct ClosestCell
+	{
+		int idx{ invalid_node_index };
+		int turnIdx{ invalid_node_index }; // where a diagonal jump turned into the straight line that passed the cell, if it did
+		T_NodeType* pJumpPoint{};
+		float hCost{};
+		float gCost{};
+	};
+
+	bool m_IsTrackingClosestCell{};
+	ClosestCell m_ClosestCell{};
+	NodeRecord m_JumpingFrom{}; // jump point the current jump started from
+	int m_TurnIdx{ invalid_node_index };
+	float m_TurnCost{};
+
 	Elite::Heuristic m_pHeuristicFunction;
 	int m_GraphColumnsCount;
 	int m_GraphRowsCount;
+	bool m_IsTerrainAware;
 
 	float GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const;
 
-	// Can only retrieve direction to adjacent node
-	Direction GetDirection(T_ConnectionType* pConnection) const;
-	bool IsNodeStillInGrid(int nodeIdx);
+	Direction GetDirection(int horDir, int verDir) const;
+	void GetDirectionOffsets(Direction direction, int& horDir, int& verDir) const;
+	bool IsNodeStillInGrid(int nodeIdx) const;
+
+	// returns the connection towards the adjacent node in the given direction, nullptr if it's out of the grid or blocked
+	T_ConnectionType* GetConnectionTo(int nodeIdx, int horDir, int verDir) const;
+
+	/// <summary>
+	/// collect the directions worth searching from a jump point, the rest have a symmetric path that is at least as short
+	/// </summary>
+	/// <param name="jumpPoint">jump point that is being expanded</param>
+	/// <returns>returns the natural and forced directions allowed by the movement policy</returns>
+	std::vector<Direction> GetPrunedDirections(const NodeRecord& jumpPoint) const;
+
+	/// <summary>
+	/// check if an obstacle next to the node forces the search to stop here
+	/// </summary>
+	/// <param name="nodeIdx">current node index</param>
+	/// <param name="horDir">horizontal value of the travel direction -1, 0 or +1</param>
+	/// <param name="verDir">vertical value of the travel direction -1, 0 or +1</param>
+	/// <returns>returns true if the node has forced neighbour(s)</returns>
+	bool HasForcedNeighbour(int nodeIdx, int horDir, int verDir) const;
+
+	// returns true if a walkable cell around the node has a different terrain cost, only used by the terrain aware search
+	bool IsOnTerrainBoundary(int nodeIdx) const;
 
 	/// <summary>
 	///	check horizontal line for any interesting node ahead
 	/// </summary>
 	/// <param name="nodeIdx"> current node index </param>
 	/// <param name="dir">horizontal direction being +1 or -1 (right or left)</param>
-	/// <returns>returns true if it found forced neighbour</returns>
-	bool HorizontalSearch(
+	/// <param name="pEndNode"></param>
+	/// <param name="travelCost">accumulates the cost of the connections travelled</param>
+	/// <returns>returns the index of the jump point found, invalid_node_index if the line hits an obstacle</returns>
+	int HorizontalSearch(
 		int nodeIdx,
 		int dir,
-		const std::vector<T_NodeType*>& grid,
 		T_NodeType* pEndNode,
-		T_NodeType* pStartNode,
-		float parentGCost);
+		float& travelCost);
 
 	/// <summary>
 	/// check vertical line for any interesting node ahead
 	/// </summary>
 	/// <param name="nodeIdx">current node index</param>
 	/// <param name="dir">vertical direction being +1 or -1 ( top or bottom )</param>
-	/// <param name="grid"></param>
 	/// <param name="pEndNode"></param>
-	/// <param name="pStartNode"></param>
-	/// <returns>returns true if found forced neighbour(s)</returns>
-	bool VerticalSearch(
+	/// <param name="travelCost">accumulates the cost of the connections travelled</param>
+	/// <returns>returns the index of the jump point found, invalid_node_index if the line hits an obstacle</returns>
+	int VerticalSearch(
 		int nodeIdx,
 		int dir,
-		const std::vector<T_NodeType*>& grid,
 		T_NodeType* pEndNode,
-		T_NodeType* pStartNode,
-		float parentGCost);
+		float& travelCost);
 
 	/// <summary>
 	/// check diagonal line for any interesting node ahead
@@ -122,42 +165,47 @@ private:
 	/// <param name="nodeIdx">current node index</param>
 	/// <param name="horDir">horizontal value for the diagonal search +1 or -1 (right or left)</param>
 	/// <param name="verDir">vertical value for the diagonal search +1 or -1 (up or down)</param>
-	/// <param name="grid"></param>
 	/// <param name="pEndNode"></param>
-	/// <param name="pStartNode"></param>
-	/// <returns>returns true if found forced neighbour(s)</returns>
-	bool DiagonalSearch(
+	/// <param name="travelCost">accumulates the cost of the connections travelled</param>
+	/// <returns>returns the index of the jump point found, invalid_node_index if the line hits an obstacle</returns>
+	int DiagonalSearch(
 		int nodeIdx,
 		int horDir,
 		int verDir,
-		const std::vector<T_NodeType*>& grid,
 		T_NodeType* pEndNode,
-		T_NodeType* pStartNode,
-		float parentGCost);
+		float& travelCost);
+
+	// remembers the cell if it's the closest to the goal so far, only while falling back is asked for
+	void TrackClosestCell(int nodeIdx, T_NodeType* pEndNode, float travelCost);
+	std::vector<T_NodeType*> GetPathToClosestCell(T_NodeType* pStartNode, bool isJumpPointsOnly);
 
-	std::vector<NodeRecord> GetRequiredPathFromNode(const NodeRecord& nodeRec, UINT requiredPath);
 	void AddJumpPoint(const NodeRecord& rec);
+	std::vector<T_NodeType*> ReconstructPath(const NodeRecord& endRecord, T_NodeType* pStartNode, bool isJumpPointsOnly) const;
 };
 
-template <typename T_NodeType, typename T_ConnectionType>
-JumpPointSearch<T_NodeType, T_ConnectionType>::JumpPointSearch(
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::JumpPointSearch(
 	Elite::IGraph<T_NodeType, T_ConnectionType>* pGraph,
 	Elite::Heuristic pHeuristicFunc,
 	int graphColCount,
-	int graphRowCount)
+	int graphRowCount,
+	bool isTerrainAware)
 	: m_pGraph(pGraph)
 	, m_OpenLists()
 	, m_VisitedJumpPoints()
 	, m_pHeuristicFunction(pHeuristicFunc)
 	, m_GraphColumnsCount(graphColCount)
 	, m_GraphRowsCount(graphRowCount)
+	, m_IsTerrainAware(isTerrainAware)
 {
 }
 
-template <typename T_NodeType, typename T_ConnectionType>
-std::vector<T_NodeType*> JumpPointSearch<T_NodeType, T_ConnectionType>::FindPath(
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+std::vector<T_NodeType*> JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::FindPath(
 	T_NodeType* pStartNode,
-	T_NodeType* pEndNode)
+	T_NodeType* pEndNode,
+	bool isJumpPointsOnly,
+	bool isFallingBackToClosest)
 {
 
 	m_OpenLists.clear();
@@ -167,159 +215,92 @@ std::vector<T_NodeType*> JumpPointSearch<T_NodeType, T_ConnectionType>::FindPath
 	if (pStartNode == pEndNode || !pStartNode || !pEndNode)
 		return std::vector<T_NodeType*>{pStartNode};
 
+	// nodes in different components can't be connected, no need to flood the reachable area to find that out.
+	// The fallback has to look at everything that is reachable anyway
+	if (!isFallingBackToClosest && !m_pGraph->AreConnected(pStartNode->GetIndex(), pEndNode->GetIndex()))
+		return std::vector<T_NodeType*>{pStartNode};
 
-	auto gridArray = m_pGraph->GetAllNodes();
-
-	// First Condition ( No parent, adds all available path from the start )
-	for (const auto& connection : m_pGraph->GetNodeConnections(pStartNode->GetIndex()))
-	{
-		if (connection->IsValid())
-		{
-			T_NodeType* pointedNode{ m_pGraph->GetNode(connection->GetTo()) };
-			const float connectionCost{ connection->GetCost() };
-
-			NodeRecord startNode{};
-
-			startNode.hCost = GetHeuristicCost(pointedNode, pEndNode);
-			startNode.gCost = connectionCost;
-			startNode.pConnection = connection;
-			startNode.pNode = pointedNode;
-			startNode.parentDirection = GetDirection(connection);
-
-			m_OpenLists.emplace_back(startNode);
-		}
-	}
-
+	// First Condition ( No parent, every available path from the start gets searched )
 	NodeRecord startNode{};
 	startNode.pNode = pStartNode;
+	startNode.hCost = GetHeuristicCost(pStartNode, pEndNode);
+
+	m_OpenLists.emplace_back(startNode);
 
-	//m_VisitedJumpPoints.emplace_back(startNode);
+	m_IsTrackingClosestCell = isFallingBackToClosest;
+	m_ClosestCell = ClosestCell{ pStartNode->GetIndex(), invalid_node_index, pStartNode, startNode.hCost, 0.f };
 
 	// HOT ZONE!!
 	while (!m_OpenLists.empty())
 	{
-		// 0. determine the best node and direction to start with ( probably needed a heuristic test )
+		// 0. determine the best jump point to continue from
 		const auto cIt{ std::min_element(m_OpenLists.begin(),m_OpenLists.end()) };
-		NodeRecord jumpPoint{ *cIt };
+		const NodeRecord jumpPoint{ *cIt };
 
-		// 1. search HORIZONTALLY for an 'interesting' node
-		// beware for the up and down blocked node
-		// if found one, depends on the direction we are going to
-		// add the diagonal node to the open list
+		// remove the visited jump point out of the open list
+		m_OpenLists.erase(cIt);
+		m_VisitedJumpPoints.emplace_back(jumpPoint);
 
-		if (jumpPoint.pNode != pEndNode)
-		{
-			// remove the visited jump point out of the open list
-			m_OpenLists.erase(cIt);
-			m_VisitedJumpPoints.emplace_back(jumpPoint);
+		if (jumpPoint.pNode == pEndNode)
+			return ReconstructPath(jumpPoint, pStartNode, isJumpPointsOnly);
 
-			int pointedIdx{ jumpPoint.pNode->GetIndex() };
-			switch (jumpPoint.parentDirection)
-			{
-			case Direction::Left:
-				HorizontalSearch(pointedIdx, -1, gridArray, pEndNode, pStartNode, jumpPoint.gCost);			break;
-			case Direction::Right:
-				HorizontalSearch(pointedIdx, 1, gridArray, pEndNode, pStartNode, jumpPoint.gCost);			break;
-			case Direction::Up:
-				VerticalSearch(pointedIdx, 1, gridArray, pEndNode, pStartNode, jumpPoint.gCost);			break;
-			case Direction::Down:
-				VerticalSearch(pointedIdx, -1, gridArray, pEndNode, pStartNode, jumpPoint.gCost);			break;
-			case Direction::TopLeft:
-				DiagonalSearch(pointedIdx, -1, 1, gridArray, pEndNode, pStartNode, jumpPoint.gCost);		break;
-			case Direction::TopRight:
-				DiagonalSearch(pointedIdx, 1, 1, gridArray, pEndNode, pStartNode, jumpPoint.gCost);			break;
-			case Direction::BottomLeft:
-				DiagonalSearch(pointedIdx, -1, -1, gridArray, pEndNode, pStartNode, jumpPoint.gCost);		break;
-			case Direction::BottomRight:
-				DiagonalSearch(pointedIdx, 1, -1, gridArray, pEndNode, pStartNode, jumpPoint.gCost);		break;
-			default:
-				break;
-			}
-		}
-		else
+		// 1. jump in every direction that isn't pruned away until we find an 'interesting' node
+		const int pointedIdx{ jumpPoint.pNode->GetIndex() };
+		for (const Direction direction : GetPrunedDirections(jumpPoint))
 		{
-			// since there's no link between jump points
-			// we gonna use the direction of the parent connection to track back to the other jump point instead
-			std::vector<T_NodeType*> path{};
-			T_NodeType* pPointedNode{ jumpPoint.pNode };
-			int traverseIdx{ jumpPoint.pNode->GetIndex() };
-			Direction toParentDir{ GetDirection(jumpPoint.pConnection) };
-
-			while (pPointedNode != pStartNode)
-			{
-				const auto parentJumpPoint = std::find_if(m_OpenLists.begin(), m_OpenLists.end(), [pPointedNode](const NodeRecord& nodeRec)
-					{
-						return pPointedNode == nodeRec.pNode;
-					});
-
-				const auto oldJumpPoint = std::find_if(m_VisitedJumpPoints.begin(), m_VisitedJumpPoints.end(), [pPointedNode](const NodeRecord& nodeRec)
-					{
-						return pPointedNode == nodeRec.pNode;
-					});
-			
-
-				// check if this node is a jump point
-				const bool shouldChangeDirection{ parentJumpPoint != m_OpenLists.end() || oldJumpPoint != m_VisitedJumpPoints.end() };
-
-				if (shouldChangeDirection)
-				{
-					if (parentJumpPoint != m_OpenLists.end())
-						toParentDir = GetDirection(parentJumpPoint->pConnection);
-					else
-						toParentDir = GetDirection(oldJumpPoint->pConnection);
-				}
-
-				// reverse
-				switch (toParentDir)
-				{
-				case Direction::Left:
-					traverseIdx += 1;
-					break;
-				case Direction::Right:
-					traverseIdx -= 1;
-					break;
-				case Direction::Up:
-					traverseIdx -= m_GraphColumnsCount;
-					break;
-				case Direction::Down:
-					traverseIdx += m_GraphColumnsCount;
-					break;
-				case Direction::TopLeft:
-					traverseIdx -= m_GraphColumnsCount - 1;
-					break;
-				case Direction::TopRight:
-					traverseIdx -= m_GraphColumnsCount + 1;
-					break;
-				case Direction::BottomLeft:
-					traverseIdx += m_GraphColumnsCount + 1;
-					break;
-				case Direction::BottomRight:
-					traverseIdx += m_GraphColumnsCount - 1;
-					break;
-				default: break;
-				}
-
-				if(IsNodeStillInGrid(traverseIdx))
-					pPointedNode = gridArray[traverseIdx];
-
-				path.emplace_back(pPointedNode);
-			}
+			int horDir{};
+			int verDir{};
+			GetDirectionOffsets(direction, horDir, verDir);
+
+			float travelCost{};
+			int foundIdx{ invalid_node_index };
+			m_JumpingFrom = jumpPoint;
+
+			if (horDir != 0 && verDir != 0)
+				foundIdx = DiagonalSearch(pointedIdx, horDir, verDir, pEndNode, travelCost);
+			else if (horDir != 0)
+				foundIdx = HorizontalSearch(pointedIdx, horDir, pEndNode, travelCost);
+			else
+				foundIdx = VerticalSearch(pointedIdx, verDir, pEndNode, travelCost);
+
+			if (foundIdx == invalid_node_index)
+				continue;
+
+			// 2. the node we landed on becomes a jump point that is waiting to be searched
+			NodeRecord interestingNode{};
+			interestingNode.pNode = m_pGraph->GetNode(foundIdx);
+			interestingNode.pParent = jumpPoint.pNode;
+			interestingNode.parentDirection = direction;
+			interestingNode.gCost = jumpPoint.gCost + travelCost;
+			interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
 
-			std::reverse(path.begin(), path.end());
-			return path;
+			AddJumpPoint(interestingNode);
 		}
 	}
 
-
+	// everything reachable got searched without meeting the goal
+	if (isFallingBackToClosest)
+		return GetPathToClosestCell(pStartNode, isJumpPointsOnly);
 
 	return std::vector<T_NodeType*>{pStartNode};
 }
 
-template <typename T_NodeType, typename T_ConnectionType>
-std::vector<NodeForRender> JumpPointSearch<T_NodeType, T_ConnectionType>::GetJumpPoints()
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+std::vector<NodeForRender> JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetJumpPoints()
 {
 	std::vector<NodeForRender> out{};
 
+	for (const auto& node : m_VisitedJumpPoints)
+	{
+		out.emplace_back(
+			NodeForRender{
+				node.pNode->GetIndex(),
+				node.gCost,
+				node.hCost
+			}
+		);
+	}
+
 	for (const auto& node : m_OpenLists)
 	{
 		out.emplace_back(
@@ -334,8 +315,8 @@ std::vector<NodeForRender> JumpPointSearch<T_NodeType, T_ConnectionType>::GetJum
 	return out;
 }
 
-template <typename T_NodeType, typename T_ConnectionType>
-float JumpPointSearch<T_NodeType, T_ConnectionType>::GetHeuristicCost(
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+float JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetHeuristicCost(
 	T_NodeType* pStartNode,
 	T_NodeType* pEndNode) const
 {
@@ -343,553 +324,479 @@ float JumpPointSearch<T_NodeType, T_ConnectionType>::GetHeuristicCost(
 	return m_pHeuristicFunction(abs(toDestination.x), abs(toDestination.y));
 }
 
-template <typename T_NodeType, typename T_ConnectionType>
-typename JumpPointSearch<T_NodeType, T_ConnectionType>::Direction JumpPointSearch<T_NodeType, T_ConnectionType>::
-GetDirection(T_ConnectionType* pConnection) const
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+typename JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::Direction JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::
+GetDirection(int horDir, int verDir) const
 {
-	const int fromIdx{ pConnection->GetFrom() };
-	const int toIdx{ pConnection->GetTo() };
-
-	const int dirIdx{ toIdx - fromIdx };
-
-	// Man, this is really ugly
-	if (dirIdx == 1)
-		return Direction::Right;
-	if (dirIdx == -1)
-		return Direction::Left;
-	if (dirIdx == m_GraphColumnsCount + 1)
-		return Direction::TopRight;
-	if (dirIdx == m_GraphColumnsCount - 1)
-		return Direction::TopLeft;
-	if (dirIdx == m_GraphColumnsCount)
-		return Direction::Up;
-	if (dirIdx == -(m_GraphColumnsCount + 1))
-		return Direction::BottomRight;
-	if (dirIdx == -(m_GraphColumnsCount - 1))
-		return Direction::BottomLeft;
-	if (dirIdx == -m_GraphColumnsCount)
-		return Direction::Down;
-
-	return Direction::None;
+	// up is towards the next row
+	if (verDir == 0)
+		return horDir < 0 ? Direction::Left : Direction::Right;
+	if (horDir == 0)
+		return verDir < 0 ? Direction::Down : Direction::Up;
+	if (verDir > 0)
+		return horDir < 0 ? Direction::TopLeft : Direction::TopRight;
+
+	return horDir < 0 ? Direction::BottomLeft : Direction::BottomRight;
 }
 
-template <typename T_NodeType, typename T_ConnectionType>
-bool JumpPointSearch<T_NodeType, T_ConnectionType>::IsNodeStillInGrid(int nodeIdx)
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+void JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetDirectionOffsets(
+	Direction direction,
+	int& horDir,
+	int& verDir) const
 {
-	return nodeIdx < (m_GraphColumnsCount* m_GraphRowsCount) - 1 && nodeIdx >= 0;
+	switch (direction)
+	{
+	case Direction::Left:			horDir = -1;	verDir = 0;		break;
+	case Direction::Right:			horDir = 1;		verDir = 0;		break;
+	case Direction::Up:				horDir = 0;		verDir = 1;		break;
+	case Direction::Down:			horDir = 0;		verDir = -1;	break;
+	case Direction::TopLeft:		horDir = -1;	verDir = 1;		break;
+	case Direction::TopRight:		horDir = 1;		verDir = 1;		break;
+	case Direction::BottomLeft:		horDir = -1;	verDir = -1;	break;
+	case Direction::BottomRight:	horDir = 1;		verDir = -1;	break;
+	default:						horDir = 0;		verDir = 0;		break;
+	}
 }
 
-template <typename T_NodeType, typename T_ConnectionType>
-bool JumpPointSearch<T_NodeType, T_ConnectionType>::HorizontalSearch(
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+bool JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::IsNodeStillInGrid(int nodeIdx) const
+{
+	return nodeIdx < m_GraphColumnsCount * m_GraphRowsCount && nodeIdx >= 0;
+}
+
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+T_ConnectionType* JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetConnectionTo(
 	int nodeIdx,
-	int dir,
-	const std::vector<T_NodeType*>& grid,
-	T_NodeType* pEndNode,
-	T_NodeType* pStartNode,
-	float parentGCost)
+	int horDir,
+	int verDir) const
 {
-	int traverseIndex{ nodeIdx };
-	float travelDistance{ parentGCost };
-	T_ConnectionType* parentConnection{};
-	bool hasFoundFirstForcedNeighbour{};
+	if (!IsNodeStillInGrid(nodeIdx))
+		return nullptr;
 
-	while (true)
+	// compare columns and rows separately, so we don't wrap around the edges of the grid
+	const int col{ nodeIdx % m_GraphColumnsCount + horDir };
+	const int row{ nodeIdx / m_GraphColumnsCount + verDir };
+
+	if (col < 0 || col >= m_GraphColumnsCount || row < 0 || row >= m_GraphRowsCount)
+		return nullptr;
+
+	// GetConnection() already return us nullptr if there's no connection to it
+	return m_pGraph->GetConnection(nodeIdx, row * m_GraphColumnsCount + col);
+}
+
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+std::vector<typename JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::Direction> JumpPointSearch<T_NodeType,
+T_ConnectionType, T_MovementPolicy>::GetPrunedDirections(const NodeRecord& jumpPoint) const
+{
+	std::vector<Direction> out{};
+	const int nodeIdx{ jumpPoint.pNode->GetIndex() };
+
+	auto addIfConnected{ [this, &out, nodeIdx](int horDir, int verDir)
 	{
-		// search along the grid
-		const int currIdx{ traverseIndex };
-		const int nextIdx{ traverseIndex += dir };
-		const int beforeIdx{ currIdx - dir };
+		if (GetConnectionTo(nodeIdx, horDir, verDir))
+			out.emplace_back(GetDirection(horDir, verDir));
+	} };
 
-		if (!IsNodeStillInGrid(nextIdx))
-			return false;
+	// the start node has no parent, so nothing can be pruned
+	// neither can a terrain boundary, a detour over cheaper terrain might be shorter than the symmetric path
+	if (jumpPoint.parentDirection == Direction::None || IsOnTerrainBoundary(nodeIdx))
+	{
+		for (const auto& connection : m_pGraph->GetNodeConnections(nodeIdx))
+		{
+			if (connection->IsValid())
+			{
+				const int toIdx{ connection->GetTo() };
+				out.emplace_back(GetDirection(
+					toIdx % m_GraphColumnsCount - nodeIdx % m_GraphColumnsCount,
+					toIdx / m_GraphColumnsCount - nodeIdx / m_GraphColumnsCount));
+			}
+		}
 
-		// check ahead if next connection is out of bound or blocked
-		parentConnection = m_pGraph->GetConnection(currIdx, nextIdx);
+		return out;
+	}
 
-		if (!parentConnection)
-			return false;
+	int horDir{};
+	int verDir{};
+	GetDirectionOffsets(jumpPoint.parentDirection, horDir, verDir);
 
-		// check if the next node is the end node
-		if (grid[nextIdx] == pEndNode)
+	if (horDir != 0 && verDir != 0)
+	{
+		// natural neighbours
+		addIfConnected(horDir, 0);
+		addIfConnected(0, verDir);
+		addIfConnected(horDir, verDir);
+
+		// forced neighbours, only when we're allowed to cut around the obstacle behind us
+		if (T_MovementPolicy::IsCornerCuttingAllowed)
 		{
-			NodeRecord endNode{};
+			if (!GetConnectionTo(nodeIdx, -horDir, 0))
+				addIfConnected(-horDir, verDir);
+			if (!GetConnectionTo(nodeIdx, 0, -verDir))
+				addIfConnected(horDir, -verDir);
+		}
 
-			endNode.pNode = pEndNode;
-			endNode.pConnection = parentConnection;
-			endNode.parentDirection = dir < 0 ? Direction::Left : Direction::Right;
-			endNode.gCost = travelDistance;
-			endNode.hCost = 0.0f;
+		return out;
+	}
 
-			m_OpenLists.emplace_back(endNode);
+	// natural neighbour
+	addIfConnected(horDir, verDir);
 
-			return true;
+	// the sides are perpendicular to the travel direction
+	for (const int side : { 1, -1 })
+	{
+		const int sideHorDir{ verDir * side };
+		const int sideVerDir{ horDir * side };
+
+		if (T_MovementPolicy::IsCornerCuttingAllowed)
+		{
+			if (!GetConnectionTo(nodeIdx, sideHorDir, sideVerDir))
+				addIfConnected(horDir + sideHorDir, verDir + sideVerDir);
 		}
+		else
+		{
+			// the jump already stopped because of this side, so every open cell around it might lead somewhere new
+			addIfConnected(sideHorDir, sideVerDir);
 
-		// check for top and bottom obstacles
-		int topIdx{ currIdx + m_GraphColumnsCount };
-		int bottomIdx{ currIdx - m_GraphColumnsCount };
+			if (T_MovementPolicy::IsDiagonalAllowed)
+				addIfConnected(horDir + sideHorDir, verDir + sideVerDir);
+		}
+	}
 
-		// GetConnection() already return us nullptr if there's no connection to it
-		T_ConnectionType* topNode{ IsNodeStillInGrid(topIdx) ?
-			m_pGraph->GetConnection(currIdx,topIdx) :
-			nullptr };
+	return out;
+}
 
-		T_ConnectionType* bottomNode{ IsNodeStillInGrid(bottomIdx) ?
-			m_pGraph->GetConnection(currIdx,bottomIdx) :
-			nullptr };
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+bool JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::HasForcedNeighbour(
+	int nodeIdx,
+	int horDir,
+	int verDir) const
+{
+	if (horDir != 0 && verDir != 0)
+	{
+		// without corner cutting there's no way around the obstacles behind us, so diagonals have no forced neighbours
+		if (!T_MovementPolicy::IsCornerCuttingAllowed)
+			return false;
+
+		return (GetConnectionTo(nodeIdx, -horDir, verDir) && !GetConnectionTo(nodeIdx, -horDir, 0))
+			|| (GetConnectionTo(nodeIdx, horDir, -verDir) && !GetConnectionTo(nodeIdx, 0, -verDir));
+	}
 
-		bool foundNeighbour{};
+	const int beforeIdx{ nodeIdx - horDir - verDir * m_GraphColumnsCount };
 
-		if (!topNode)
+	for (const int side : { 1, -1 })
+	{
+		const int sideHorDir{ verDir * side };
+		const int sideVerDir{ horDir * side };
+
+		if (T_MovementPolicy::IsCornerCuttingAllowed)
 		{
-			// Check if this connection is blocked
-			//if (!topNode->IsValid())
-			//{
-				if(!hasFoundFirstForcedNeighbour)
-				{
-					// if it's a blockade then we add the forced neighbour in our open list
-					// provide that the node itself is also not a blockade
-					int topForcedNeighbourIdx{ currIdx + m_GraphColumnsCount + dir };
-
-					T_ConnectionType* topForcedNeighbour{ IsNodeStillInGrid(topForcedNeighbourIdx) ?
-						m_pGraph->GetConnection(currIdx,topForcedNeighbourIdx) :
-						nullptr
-					};
-
-					if (topForcedNeighbour)
-					{
-						if (topForcedNeighbour->IsValid())
-						{
-							NodeRecord interestingNode{};
-							interestingNode.pNode = grid[topForcedNeighbourIdx];
-							interestingNode.pConnection = topForcedNeighbour;
-							interestingNode.parentDirection = (dir < 0 ? Direction::TopLeft : Direction::TopRight);
-							interestingNode.gCost = travelDistance + topForcedNeighbour->GetCost();
-							interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-
-							m_OpenLists.emplace_back(interestingNode);
-
-							hasFoundFirstForcedNeighbour = true;
-							foundNeighbour = true;
-						}
-					}
-				}
-				else
-				{
-					// add ourself then return
-					NodeRecord interestingNode{};
-					interestingNode.pNode = grid[currIdx];
-					interestingNode.pConnection = m_pGraph->GetConnection(beforeIdx, currIdx);
-					interestingNode.parentDirection = dir < 0 ? Direction::Left : Direction::Right;
-					interestingNode.gCost = travelDistance + interestingNode.pConnection->GetCost();
-					interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-
-					m_OpenLists.emplace_back(interestingNode);
-					return true;
-				}
-			//}
+			// blocked side, but the node diagonally ahead of it can be reached
+			if (!GetConnectionTo(nodeIdx, sideHorDir, sideVerDir) &&
+				GetConnectionTo(nodeIdx, horDir + sideHorDir, verDir + sideVerDir))
+				return true;
 		}
-
-		if (!bottomNode)
+		else
 		{
-			//// Check if this connection is blocked
-			//if (!bottomNode->IsValid())
-			//{
-				if(!hasFoundFirstForcedNeighbour)
-				{
-					// same with the top forced neighbour one
-					int bottomForcedNeighbourIdx{ currIdx - m_GraphColumnsCount + dir };
-
-					T_ConnectionType* bottomForcedNeighbour{ IsNodeStillInGrid(bottomForcedNeighbourIdx) ?
-						m_pGraph->GetConnection(currIdx,bottomForcedNeighbourIdx) :
-						nullptr
-					};
-
-					if (bottomForcedNeighbour)
-					{
-						if (bottomForcedNeighbour->IsValid())
-						{
-							NodeRecord interestingNode{};
-							interestingNode.pNode = grid[bottomForcedNeighbourIdx];
-							interestingNode.pConnection = bottomForcedNeighbour;
-							interestingNode.parentDirection = (dir < 0 ? Direction::BottomLeft : Direction::BottomRight);
-							interestingNode.gCost = travelDistance + bottomForcedNeighbour->GetCost();
-							interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-
-							m_OpenLists.emplace_back(interestingNode);
-							hasFoundFirstForcedNeighbour = true;
-							foundNeighbour = true;
-						}
-					}
-				}
-				else
-				{
-					// add ourself then return
-					NodeRecord interestingNode{};
-					interestingNode.pNode = grid[currIdx];
-					interestingNode.pConnection = m_pGraph->GetConnection(beforeIdx, currIdx);
-					interestingNode.parentDirection = dir < 0 ? Direction::Left : Direction::Right;
-					interestingNode.gCost = travelDistance + interestingNode.pConnection->GetCost();
-					interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-
-					m_OpenLists.emplace_back(interestingNode);
-					return true;
-				}
-			//}
+			// open side that was still blocked one step back
+			if (GetConnectionTo(nodeIdx, sideHorDir, sideVerDir) &&
+				!GetConnectionTo(beforeIdx, sideHorDir, sideVerDir))
+				return true;
 		}
+	}
+
+	return false;
+}
+
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+bool JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::IsOnTerrainBoundary(int nodeIdx) const
+{
+	if (!m_IsTerrainAware)
+		return false;
+
+	const float terrainCost{ Elite::GetTerrainCost(m_pGraph->GetNode(nodeIdx)) };
+	const int col{ nodeIdx % m_GraphColumnsCount };
+	const int row{ nodeIdx / m_GraphColumnsCount };
 
+	// look at all 8 surrounding cells, even without diagonal connections a detour around the corner can be cheaper
+	for (int verDir{ -1 }; verDir <= 1; ++verDir)
+	{
+		for (int horDir{ -1 }; horDir <= 1; ++horDir)
+		{
+			const int neighbourCol{ col + horDir };
+			const int neighbourRow{ row + verDir };
+
+			if (neighbourCol < 0 || neighbourCol >= m_GraphColumnsCount || neighbourRow < 0 || neighbourRow >= m_GraphRowsCount)
+				continue;
+
+			const int neighbourIdx{ neighbourRow * m_GraphColumnsCount + neighbourCol };
 
+			// obstacles are already handled by the forced neighbour rules
+			if (m_pGraph->GetNodeConnections(neighbourIdx).empty())
+				continue;
 
-//		if (foundNeighbour)
-//		{
-//			if (hasFoundFirstForcedNeighbour)
-//			{
-//
-//			}
-//#pragma region Temp
-//			//NodeRecord interestingNode{};
-//			//interestingNode.pNode = grid[currIdx];
-//			//interestingNode.parentDirection = dir < 0 ? Direction::Left : Direction::Right;
-//			//interestingNode.pConnection = m_pGraph->GetConnection(beforeIdx,currIdx);
-//			//interestingNode.hCost = GetHeuristicCost(grid[currIdx], pEndNode);
-//
-//			//interestingNode.gCost = travelDistance;
-//
-//			//AddJumpPoint(interestingNode);
-//			//
-//			//// add all the path available from this node waited to be searched
-//			//// pretty much also add the 'forced neighbours' that we found along the way to be jump points
-//
-//			//UINT requiredPath{};
-//			//
-//			//if (dir < 0) // left
-//			//{
-//			//	// check for top left, bottom left if the path is available
-//			//	// if so then add it to the open list
-//			//	requiredPath = UINT(Direction::TopLeft) | UINT(Direction::BottomLeft);
-//			//}
-//			//else // right
-//			//{
-//			//	// check for top right, bottom right
-//			//	requiredPath = UINT(Direction::TopRight) | UINT(Direction::BottomRight);
-//			//}
-//
-//			//auto connectedPath{ GetRequiredPathFromNode(interestingNode,requiredPath) };
-//			//for (const auto& path : connectedPath)
-//			//{
-//			//	AddJumpPoint(path);
-//			//}
-//			//
-//			//return true;
-//#pragma endregion 
-//		}
-
-		travelDistance += parentConnection->GetCost();
+			if (Elite::GetTerrainCost(m_pGraph->GetNode(neighbourIdx)) != terrainCost)
+				return true;
+		}
 	}
+
+	return false;
 }
 
-template <typename T_NodeType, typename T_ConnectionType>
-bool JumpPointSearch<T_NodeType, T_ConnectionType>::VerticalSearch(
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+int JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::HorizontalSearch(
 	int nodeIdx,
 	int dir,
-	const std::vector<T_NodeType*>& grid,
 	T_NodeType* pEndNode,
-	T_NodeType* pStartNode,
-	float parentGCost)
+	float& travelCost)
 {
 	int traverseIndex{ nodeIdx };
-	float travelDistance{ parentGCost };
-	T_ConnectionType* parentConnection{};
-	bool hasFoundFirstForcedNeighbour{};
 
 	while (true)
 	{
-		// search along the grid
-		const int currIdx{ traverseIndex };
-		const int nextIdx{ traverseIndex += m_GraphColumnsCount * dir };
-		const int beforeIdx{ currIdx - m_GraphColumnsCount * dir };
-
-		if (!IsNodeStillInGrid(nextIdx))
-			return false;
-
-		// return if it's out of bound
-		//if (traverseIndex % m_GraphRowsCount == 0)
-		//	return false;
-		// vertical search only out of bound when it's outside of the grid
-
-		// update parent node info
-		parentConnection = m_pGraph->GetConnection(currIdx, nextIdx);
+		// check ahead if next connection is out of bound or blocked
+		T_ConnectionType* parentConnection{ GetConnectionTo(traverseIndex, dir, 0) };
 
 		if (!parentConnection)
-			return false;
-
-		// check if the next node is the end node
-		if (grid[nextIdx] == pEndNode)
-		{
-			NodeRecord endNode{};
+			return invalid_node_index;
 
-			endNode.pNode = pEndNode;
-			endNode.pConnection = parentConnection;
-			endNode.parentDirection = dir < 0 ? Direction::Down : Direction::Up;
-			endNode.gCost = travelDistance;
-			endNode.hCost = 0.0f;
+		// search along the grid
+		traverseIndex = parentConnection->GetTo();
+		travelCost += parentConnection->GetCost();
+		TrackClosestCell(traverseIndex, pEndNode, travelCost);
 
-			m_OpenLists.emplace_back(endNode);
+		// check if the next node is the end node
+		if (traverseIndex == pEndNode->GetIndex())
+			return traverseIndex;
 
-			return true;
-		}
+		// check for top and bottom obstacles
+		if (HasForcedNeighbour(traverseIndex, dir, 0) || IsOnTerrainBoundary(traverseIndex))
+			return traverseIndex;
+	}
+}
 
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+int JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::VerticalSearch(
+	int nodeIdx,
+	int dir,
+	T_NodeType* pEndNode,
+	float& travelCost)
+{
+	int traverseIndex{ nodeIdx };
 
-		// check for left and right obstacles
-		const int leftIdx{ currIdx - 1 };
-		const int rightIdx{ currIdx + 1 };
+	while (true)
+	{
+		// vertical search only out of bound when it's outside of the grid
+		T_ConnectionType* parentConnection{ GetConnectionTo(traverseIndex, 0, dir) };
 
+		if (!parentConnection)
+			return invalid_node_index;
 
-		// GetConnection() already return us nullptr if there's no connection to it
-		T_ConnectionType* leftNode{ IsNodeStillInGrid(leftIdx) ?
-			m_pGraph->GetConnection(currIdx,leftIdx) :
-			nullptr };
+		traverseIndex = parentConnection->GetTo();
+		travelCost += parentConnection->GetCost();
+		TrackClosestCell(traverseIndex, pEndNode, travelCost);
 
-		T_ConnectionType* rightNode{ IsNodeStillInGrid(rightIdx) ?
-			m_pGraph->GetConnection(currIdx,rightIdx) :
-			nullptr };
+		// check if the next node is the end node
+		if (traverseIndex == pEndNode->GetIndex())
+			return traverseIndex;
 
-		bool foundNeighbour{};
+		// check for left and right obstacles
+		if (HasForcedNeighbour(traverseIndex, 0, dir) || IsOnTerrainBoundary(traverseIndex))
+			return traverseIndex;
 
-		if (!leftNode)
+		// without diagonals the horizontal lines can only be reached by turning on this vertical line
+		if (!T_MovementPolicy::IsDiagonalAllowed)
 		{
-			//if (!leftNode->IsValid())
-			//{
-				if(!hasFoundFirstForcedNeighbour)
-				{
-					// if it's a blockade then we add the forced neighbours in our open list
-					// provide that the node itself is also not a blockade
-					const int leftForcedNeighbourIdx{ currIdx + (m_GraphColumnsCount * dir) - 1 };
-
-					T_ConnectionType* leftForcedNeighbour{ IsNodeStillInGrid(leftForcedNeighbourIdx) ?
-						m_pGraph->GetConnection(currIdx,leftForcedNeighbourIdx) :
-						nullptr
-					};
-
-					if (leftForcedNeighbour)
-					{
-						if (leftForcedNeighbour->IsValid())
-						{
-							NodeRecord interestingNode{};
-							interestingNode.pNode = grid[leftForcedNeighbourIdx];
-							interestingNode.pConnection = leftForcedNeighbour;
-							interestingNode.parentDirection = (dir < 0 ? Direction::BottomLeft : Direction::TopLeft);
-							interestingNode.gCost = travelDistance + leftForcedNeighbour->GetCost();
-							interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-
-							m_OpenLists.emplace_back(interestingNode);
-							foundNeighbour = true;
-							hasFoundFirstForcedNeighbour = true;
-						}
-					}
-				}
-				else
-				{
-					NodeRecord interestingNode{};
-					interestingNode.pNode = grid[currIdx];
-					interestingNode.pConnection = m_pGraph->GetConnection(beforeIdx,currIdx);
-					interestingNode.parentDirection = dir < 0 ? Direction::Down : Direction::Up;
-					interestingNode.gCost = travelDistance + interestingNode.pConnection->GetCost();
-					interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-
-					m_OpenLists.emplace_back(interestingNode);
-					return true;
-				}
-			//}
-		}
+			m_TurnIdx = traverseIndex;
+			m_TurnCost = travelCost;
 
-		if (!rightNode)
-		{
-			//if (!rightNode->IsValid())
-			//{
-				if(!hasFoundFirstForcedNeighbour)
-				{
-					// same with the top forced neighbour one
-					const int rightForcedNeighbourIdx{ currIdx + (m_GraphColumnsCount * dir) + 1 };
-
-					T_ConnectionType* rightForcedNeighbour{ IsNodeStillInGrid(rightForcedNeighbourIdx) ?
-						m_pGraph->GetConnection(currIdx,rightForcedNeighbourIdx) :
-						nullptr
-					};
-
-					if (rightForcedNeighbour)
-					{
-						if (rightForcedNeighbour->IsValid())
-						{
-							NodeRecord interestingNode{};
-							interestingNode.pNode = grid[rightForcedNeighbourIdx];
-							interestingNode.pConnection = rightForcedNeighbour;
-							interestingNode.parentDirection = dir < 0 ? Direction::BottomRight : Direction::TopRight;
-							interestingNode.gCost = travelDistance + rightForcedNeighbour->GetCost();
-							interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-
-							m_OpenLists.emplace_back(interestingNode);
-							foundNeighbour = true;
-							hasFoundFirstForcedNeighbour = true;
-						}
-					}
-				}
-				else
-				{
-					NodeRecord interestingNode{};
-					interestingNode.pNode = grid[currIdx];
-					interestingNode.pConnection = m_pGraph->GetConnection(beforeIdx, currIdx);
-					interestingNode.parentDirection = dir < 0 ? Direction::Down : Direction::Up;
-					interestingNode.gCost = travelDistance + interestingNode.pConnection->GetCost();
-					interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-
-					m_OpenLists.emplace_back(interestingNode);
-					return true;
-				}
-			//}
-		}
+			float rightCost{};
+			float leftCost{};
+			const bool isTurnInteresting{ HorizontalSearch(traverseIndex, 1, pEndNode, rightCost) != invalid_node_index ||
+				HorizontalSearch(traverseIndex, -1, pEndNode, leftCost) != invalid_node_index };
 
-		//if (foundNeighbour)
-		//{
-		//	NodeRecord interestingNode{};
-		//	interestingNode.pNode = grid[nextIdx];
-		//	interestingNode.pConnection = parentConnection;
-		//	interestingNode.parentDirection = dir < 0 ? Direction::Down : Direction::Up;
-		//	interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-
-		//	interestingNode.gCost = travelDistance;
-
-		//	m_OpenLists.emplace_back(interestingNode);
-
-		//	// same with horizontal search
-		//	// add all passable path to the open list to be searched
-		//	UINT requiredPath{};
-		//	if(dir < 0) // Down
-		//	{
-		//		// check for bottom left, bottom right
-		//		requiredPath = UINT(Direction::BottomLeft) | UINT(Direction::BottomRight);
-		//	}
-		//	else // UP
-		//	{
-		//		// check for top left, top right
-		//		requiredPath = UINT(Direction::TopLeft) | UINT(Direction::TopRight);
-		//	}
-
-		//	auto connectedPath{ GetRequiredPathFromNode(interestingNode,requiredPath) };
-		//	for (const auto& path : connectedPath)
-		//		m_OpenLists.emplace_back(path);
-		//	
-
-		//	return true;
-		//}
-
-		travelDistance += parentConnection->GetCost();
+			m_TurnIdx = invalid_node_index;
+			if (isTurnInteresting)
+				return traverseIndex;
+		}
 	}
 }
 
-template <typename T_NodeType, typename T_ConnectionType>
-bool JumpPointSearch<T_NodeType, T_ConnectionType>::DiagonalSearch(
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+int JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::DiagonalSearch(
 	int nodeIdx,
 	int horDir,
 	int verDir,
-	const std::vector<T_NodeType*>& grid,
 	T_NodeType* pEndNode,
-	T_NodeType* pStartNode,
-	float parentGCost)
+	float& travelCost)
 {
 	int traverseIdx{ nodeIdx };
-	float travelDistance{ parentGCost };
 
 	while (true)
 	{
-		const bool foundHorForcedNeighbour{ HorizontalSearch(traverseIdx,horDir,grid,pEndNode,pStartNode,travelDistance) };
-		const bool foundVerForcedNeighbour{ VerticalSearch(traverseIdx,verDir,grid,pEndNode,pStartNode,travelDistance) };
-
 		// move the node by the horizontal value and vertical value
-		const int currentIdx{ traverseIdx };
-		const int nextIdx{ traverseIdx += (m_GraphColumnsCount * verDir) + horDir };
-		const int beforeIdx{ currentIdx - (m_GraphColumnsCount * verDir) + horDir };
+		T_ConnectionType* parentConnection{ GetConnectionTo(traverseIdx, horDir, verDir) };
 
-		if (!IsNodeStillInGrid(nextIdx))
-			return false;
+		if (!parentConnection)
+			return invalid_node_index;
 
-		T_ConnectionType* parentConnection{ m_pGraph->GetConnection(currentIdx,nextIdx) };
+		traverseIdx = parentConnection->GetTo();
+		travelCost += parentConnection->GetCost();
+		TrackClosestCell(traverseIdx, pEndNode, travelCost);
 
-		if (!parentConnection)
-			return false;
+		if (traverseIdx == pEndNode->GetIndex())
+			return traverseIdx;
 
-		// check if out of bound
-		//if (abs(currentCol - nextCol) > 1)
-		//	return false;
+		// check for the diagonal forced neighbour
+		if (HasForcedNeighbour(traverseIdx, horDir, verDir) || IsOnTerrainBoundary(traverseIdx))
+			return traverseIdx;
 
-		if (grid[nextIdx] == pEndNode)
-		{
-			NodeRecord interestingNode{};
-			interestingNode.pNode = pEndNode;
-			interestingNode.pConnection = parentConnection;
-			interestingNode.parentDirection = GetDirection(parentConnection);
-			interestingNode.gCost = travelDistance;
-			interestingNode.hCost = 0.0f;
+		// this node is a jump point as well if one of its straight lines finds something interesting
+		m_TurnIdx = traverseIdx;
+		m_TurnCost = travelCost;
 
-			m_OpenLists.emplace_back(interestingNode);
+		float horizontalCost{};
+		float verticalCost{};
+		const bool isTurnInteresting{ HorizontalSearch(traverseIdx, horDir, pEndNode, horizontalCost) != invalid_node_index ||
+			VerticalSearch(traverseIdx, verDir, pEndNode, verticalCost) != invalid_node_index };
 
-			return true;
-		}
+		m_TurnIdx = invalid_node_index;
+		if (isTurnInteresting)
+			return traverseIdx;
+	}
+}
 
-		// check for the diagonal forced neighbour
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+void JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::TrackClosestCell(
+	int nodeIdx,
+	T_NodeType* pEndNode,
+	float travelCost)
+{
+	if (!m_IsTrackingClosestCell)
+		return;
 
-		if (foundHorForcedNeighbour || foundVerForcedNeighbour)
-		{
-			NodeRecord interestingNode{};
-			interestingNode.pNode = grid[currentIdx];
-			interestingNode.pConnection = parentConnection;
-			interestingNode.gCost = travelDistance;
-			interestingNode.hCost = GetHeuristicCost(interestingNode.pNode, pEndNode);
-			interestingNode.parentDirection = GetDirection(parentConnection);
+	// a cell passed after a turn is reached over the turn, the travel cost then starts counting from there
+	const float gCost{ m_JumpingFrom.gCost + (m_TurnIdx != invalid_node_index ? m_TurnCost : 0.f) + travelCost };
+	const float hCost{ GetHeuristicCost(m_pGraph->GetNode(nodeIdx), pEndNode) };
 
-			m_OpenLists.emplace_back(interestingNode);
+	if (hCost < m_ClosestCell.hCost || (hCost == m_ClosestCell.hCost && gCost < m_ClosestCell.gCost))
+		m_ClosestCell = ClosestCell{ nodeIdx, m_TurnIdx, m_JumpingFrom.pNode, hCost, gCost };
+}
 
-			return true;
-		}
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+std::vector<T_NodeType*> JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetPathToClosestCell(
+	T_NodeType* pStartNode,
+	bool isJumpPointsOnly)
+{
+	if (m_ClosestCell.idx == pStartNode->GetIndex())
+		return std::vector<T_NodeType*>{pStartNode};
 
-		travelDistance += parentConnection->GetCost();
+	// the turn becomes a jump point of its own, so the path can walk back over straight and diagonal lines only
+	T_NodeType* pParent{ m_ClosestCell.pJumpPoint };
+	if (m_ClosestCell.turnIdx != invalid_node_index)
+	{
+		NodeRecord turn{};
+		turn.pNode = m_pGraph->GetNode(m_ClosestCell.turnIdx);
+		turn.pParent = m_ClosestCell.pJumpPoint;
+		m_VisitedJumpPoints.emplace_back(turn);
+		pParent = turn.pNode;
 	}
+
+	NodeRecord closest{};
+	closest.pNode = m_pGraph->GetNode(m_ClosestCell.idx);
+	closest.pParent = pParent;
+	closest.gCost = m_ClosestCell.gCost;
+	closest.hCost = m_ClosestCell.hCost;
+	return ReconstructPath(closest, pStartNode, isJumpPointsOnly);
 }
 
-template <typename T_NodeType, typename T_ConnectionType>
-std::vector<typename JumpPointSearch<T_NodeType, T_ConnectionType>::NodeRecord> JumpPointSearch<T_NodeType,
-T_ConnectionType>::GetRequiredPathFromNode(const NodeRecord& nodeRec, UINT requiredPath)
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+void JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::AddJumpPoint(const NodeRecord& rec)
 {
-	std::vector<NodeRecord> out{};
-	
-	for (const auto& connection : m_pGraph->GetNodeConnections(nodeRec.pNode->GetIndex()))
+	// already searched from this node through a path that is at least as short
+	const auto visitedIt{ std::find_if(m_VisitedJumpPoints.begin(), m_VisitedJumpPoints.end(), [&rec](const NodeRecord& nodeRec)
+		{
+			return nodeRec.pNode == rec.pNode;
+		}) };
+
+	if (visitedIt != m_VisitedJumpPoints.end())
 	{
-		if(connection->IsValid())
+		if (visitedIt->gCost <= rec.gCost)
+			return;
+
+		m_VisitedJumpPoints.erase(visitedIt);
+	}
+
+	const auto fIt{ std::find_if(m_OpenLists.begin(), m_OpenLists.end(), [&rec](const NodeRecord& nodeRec)
 		{
-			const Direction toDirection{ GetDirection(connection) };
-			if(requiredPath & toDirection)
+			return nodeRec.pNode == rec.pNode;
+		}) };
+
+	if (fIt == m_OpenLists.end())
+		m_OpenLists.emplace_back(rec);
+	else if (rec.gCost < fIt->gCost)
+		*fIt = rec;
+}
+
+template <typename T_NodeType, typename T_ConnectionType, typename T_MovementPolicy>
+std::vector<T_NodeType*> JumpPointSearch<T_NodeType, T_ConnectionType, T_MovementPolicy>::ReconstructPath(
+	const NodeRecord& endRecord,
+	T_NodeType* pStartNode,
+	bool isJumpPointsOnly) const
+{
+	// since there's no link between jump points
+	// we walk the straight or diagonal line back to the parent jump point instead
+	std::vector<T_NodeType*> path{};
+	NodeRecord currentRecord{ endRecord };
+
+	while (currentRecord.pNode != pStartNode)
+	{
+		// the chain back to the start is broken, treat it as no path
+		if (!currentRecord.pParent)
+			return std::vector<T_NodeType*>{ pStartNode };
+
+		const int parentIdx{ currentRecord.pParent->GetIndex() };
+		const int parentCol{ parentIdx % m_GraphColumnsCount };
+		const int parentRow{ parentIdx / m_GraphColumnsCount };
+
+		int col{ currentRecord.pNode->GetIndex() % m_GraphColumnsCount };
+		int row{ currentRecord.pNode->GetIndex() / m_GraphColumnsCount };
+
+		const int horDir{ (parentCol > col) - (parentCol < col) };
+		const int verDir{ (parentRow > row) - (parentRow < row) };
+
+		if (isJumpPointsOnly)
+		{
+			path.emplace_back(currentRecord.pNode);
+		}
+		else
+		{
+			while (col != parentCol || row != parentRow)
 			{
-				NodeRecord path{};
-				path.pNode = nodeRec.pNode;
-				path.pConnection = nodeRec.pConnection;
-				path.parentDirection = toDirection;
-				path.gCost = nodeRec.gCost;
-				path.hCost = nodeRec.hCost;
-
-				out.emplace_back(path);
+				path.emplace_back(m_pGraph->GetNode(row * m_GraphColumnsCount + col));
+				col += horDir;
+				row += verDir;
 			}
 		}
-	}
 
-	return out;
-}
+		T_NodeType* pParent{ currentRecord.pParent };
+		auto isParent{ [pParent](const NodeRecord& nodeRec) { return nodeRec.pNode == pParent; } };
 
-template <typename T_NodeType, typename T_ConnectionType>
-void JumpPointSearch<T_NodeType, T_ConnectionType>::AddJumpPoint(const NodeRecord& rec)
-{
-	const auto fIt{ std::find(m_OpenLists.begin(),m_OpenLists.end(),rec) };
-	if(fIt == m_OpenLists.end())
-		m_OpenLists.emplace_back(rec);
-	
-}
+		const auto parentJumpPoint{ std::find_if(m_VisitedJumpPoints.begin(), m_VisitedJumpPoints.end(), isParent) };
+		if (parentJumpPoint != m_VisitedJumpPoints.end())
+		{
+			currentRecord = *parentJumpPoint;
+			continue;
+		}
+
+		const auto openJumpPoint{ std::find_if(m_OpenLists.begin(), m_OpenLists.end(), isParent) };
+		if (openJumpPoint == m_OpenLists.end())
+			return std::vector<T_NodeType*>{ pStartNode };
 
+		currentRecord = *openJumpPoint;
+	}
+
+	path.emplace_back(pStartNode);
+	std::reverse(path.begin(), path.end());
+	return path;
+}
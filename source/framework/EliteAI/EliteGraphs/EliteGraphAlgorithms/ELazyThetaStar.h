@@ -0,0 +1,185 @@
+#pragma once
+#include <queue>
+#include "projects/Helpers.h"
+#include "framework/EliteAI/EliteNavigation/Algorithms/EGridPathSmoothing.h"
+
+namespace Elite
+{
+	// Any-angle variant of AStar for grid graphs, a node can take the parent of its parent as long as it can see it
+	// Lazy: the line of sight is only checked once a node gets expanded instead of for every neighbour
+	// Costs are euclidean distances in cells scaled by the terrain cost, so use an euclidean heuristic
+	//--- References ---
+	//http://idm-lab.org/bib/abstracts/papers/aaai10b.pdf
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy = AllowCornerCutting>
+	class LazyThetaStar
+	{
+	public:
+		LazyThetaStar(GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph, Heuristic hFunction);
+
+		struct NodeRecord
+		{
+			T_NodeType* pParent = nullptr;
+			float costSoFar = 0.f;
+			bool isOpen = false;
+			bool isClosed = false;
+		};
+
+		// returns the corners of the path only, the cells in between can be reached in a straight line
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+		std::vector<NodeForRender> GetVisitedNodeIdx();
+
+	private:
+		float GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const;
+		float GetStraightCost(T_NodeType* pFromNode, T_NodeType* pToNode) const;
+
+		// the parent might not be visible anymore, fall back on the cheapest expanded neighbour
+		void SetParent(T_NodeType* pNode);
+
+		// indexed by node index, nodes that weren't reached yet have no parent
+		std::vector<NodeRecord> m_NodeRecords;
+		GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* m_pGraph;
+		Heuristic m_HeuristicFunction;
+	};
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	LazyThetaStar<T_NodeType, T_ConnectionType, T_MovementPolicy>::LazyThetaStar(
+		GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph,
+		Heuristic hFunction)
+		: m_pGraph(pGraph)
+		, m_HeuristicFunction(hFunction)
+	{
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	std::vector<T_NodeType*> LazyThetaStar<T_NodeType, T_ConnectionType, T_MovementPolicy>::FindPath(
+		T_NodeType* pStartNode,
+		T_NodeType* pGoalNode)
+	{
+		m_NodeRecords.assign(m_pGraph->GetNrOfNodes(), NodeRecord{});
+
+		if (pStartNode == pGoalNode || !m_pGraph->AreConnected(pStartNode->GetIndex(), pGoalNode->GetIndex()))
+			return std::vector<T_NodeType*>{pStartNode};
+
+		// (f-cost, node index), outdated entries are skipped when they come out
+		using OpenEntry = std::pair<float, int>;
+		std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> openList{};
+
+		NodeRecord& startRecord = m_NodeRecords[pStartNode->GetIndex()];
+		startRecord.pParent = pStartNode;
+		startRecord.isOpen = true;
+		openList.emplace(GetHeuristicCost(pStartNode, pGoalNode), pStartNode->GetIndex());
+
+		while (!openList.empty())
+		{
+			const int currentIdx = openList.top().second;
+			openList.pop();
+
+			NodeRecord& currentRecord = m_NodeRecords[currentIdx];
+			if (currentRecord.isClosed)
+				continue;
+
+			T_NodeType* pCurrentNode = m_pGraph->GetNode(currentIdx);
+			SetParent(pCurrentNode);
+			currentRecord.isOpen = false;
+			currentRecord.isClosed = true;
+
+			if (pCurrentNode == pGoalNode)
+			{
+				std::vector<T_NodeType*> path{};
+				T_NodeType* pPathNode = pGoalNode;
+				while (pPathNode != pStartNode)
+				{
+					path.emplace_back(pPathNode);
+					pPathNode = m_NodeRecords[pPathNode->GetIndex()].pParent;
+				}
+
+				path.emplace_back(pStartNode);
+				std::reverse(path.begin(), path.end());
+				return path;
+			}
+
+			// assume every neighbour can see our parent, SetParent corrects it when it gets expanded
+			T_NodeType* pParent = currentRecord.pParent;
+			const float parentCostSoFar = m_NodeRecords[pParent->GetIndex()].costSoFar;
+
+			for (const auto& connection : m_pGraph->GetNodeConnections(currentIdx))
+			{
+				if (!connection->IsValid())
+					continue;
+
+				NodeRecord& neighbourRecord = m_NodeRecords[connection->GetTo()];
+				if (neighbourRecord.isClosed)
+					continue;
+
+				T_NodeType* pNeighbour = m_pGraph->GetNode(connection->GetTo());
+				const float costSoFar = parentCostSoFar + GetStraightCost(pParent, pNeighbour);
+
+				if (!neighbourRecord.isOpen || costSoFar < neighbourRecord.costSoFar)
+				{
+					neighbourRecord.pParent = pParent;
+					neighbourRecord.costSoFar = costSoFar;
+					neighbourRecord.isOpen = true;
+					openList.emplace(costSoFar + GetHeuristicCost(pNeighbour, pGoalNode), connection->GetTo());
+				}
+			}
+		}
+
+		return std::vector<T_NodeType*>{pStartNode};
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void LazyThetaStar<T_NodeType, T_ConnectionType, T_MovementPolicy>::SetParent(T_NodeType* pNode)
+	{
+		NodeRecord& record = m_NodeRecords[pNode->GetIndex()];
+		if (record.pParent == pNode || GridPathSmoothing::HasLineOfSight(m_pGraph, record.pParent, pNode))
+			return;
+
+		// the neighbour that opened this node is closed, so there is always at least one candidate
+		record.pParent = nullptr;
+		for (const auto& connection : m_pGraph->GetNodeConnections(pNode->GetIndex()))
+		{
+			const NodeRecord& neighbourRecord = m_NodeRecords[connection->GetTo()];
+			if (!connection->IsValid() || !neighbourRecord.isClosed)
+				continue;
+
+			T_NodeType* pNeighbour = m_pGraph->GetNode(connection->GetTo());
+			const float costSoFar = neighbourRecord.costSoFar + GetStraightCost(pNeighbour, pNode);
+
+			if (!record.pParent || costSoFar < record.costSoFar)
+			{
+				record.pParent = pNeighbour;
+				record.costSoFar = costSoFar;
+			}
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	std::vector<NodeForRender> LazyThetaStar<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetVisitedNodeIdx()
+	{
+		std::vector<NodeForRender> out{};
+
+		for (int idx = 0; idx < int(m_NodeRecords.size()); ++idx)
+		{
+			if (m_NodeRecords[idx].isClosed)
+				out.emplace_back(NodeForRender{ idx, m_NodeRecords[idx].costSoFar });
+		}
+
+		return out;
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	float LazyThetaStar<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetHeuristicCost(T_NodeType* pStartNode, T_NodeType* pEndNode) const
+	{
+		Vector2 toDestination = m_pGraph->GetNodePos(pEndNode) - m_pGraph->GetNodePos(pStartNode);
+		return m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y));
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	float LazyThetaStar<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetStraightCost(T_NodeType* pFromNode, T_NodeType* pToNode) const
+	{
+		// a line of sight never crosses terrain, different terrain at both ends means it's a step to the neighbour
+		// which gets the average cost just like the connections of the grid
+		const float terrainCost = (GetTerrainCost(pFromNode) + GetTerrainCost(pToNode)) / 2.f;
+		return Distance(m_pGraph->GetNodePos(pFromNode), m_pGraph->GetNodePos(pToNode)) * terrainCost;
+	}
+}
@@ -0,0 +1,554 @@
+#pragma once
+#include <queue>
+#include "projects/Helpers.h"
+#include "framework/EliteHelpers/EParallel.h"
+
+namespace Elite
+{
+	// Simple subgoal graph, preprocessing for static grid maps with uniform costs
+	// Subgoals sit at the convex corners of obstacles, every shortest path only has to bend at those.
+	// Two cells are h-reachable when a path of heuristic length connects them (only moving towards the other cell),
+	// subgoals that are h-reachable without passing another subgoal get linked.
+	// A query links start and goal to the subgoals they can reach that way and runs AStar on the small graph.
+	//--- References ---
+	//https://www.aaai.org/ocs/index.php/ICAPS/ICAPS13/paper/view/6059
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy = AllowCornerCutting>
+	class SubgoalGraph
+	{
+	public:
+		// builds the subgoal graph straight away, call Update() or Build() again after changing the grid
+		SubgoalGraph(GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph, Heuristic hFunction);
+
+		// the rows and the subgoals are spread over the default task pool, the result doesn't depend on the amount of threads.
+		// Progress goes over linking the subgoals, by far the most work
+		void Build(const ProgressCallback& progress = nullptr);
+
+		// false when the grid's change journal moved on since the subgoals were built
+		bool IsUpToDate() const { return m_GraphVersion == m_pGraph->GetChangeJournal().GetVersion(); }
+		// rebuilds only when the grid changed, returns true when it had to
+		bool Update();
+
+		// false when a walkable cell has other terrain than ground, the paths can then cost more than the shortest one.
+		// Use another path finder (JPS for instance) on such grids
+		bool IsUniformCost() const { return m_IsUniformCost; }
+
+		// returns the full cell by cell path, just like AStar
+		std::vector<T_NodeType*> FindPath(T_NodeType* pStartNode, T_NodeType* pDestinationNode);
+
+		const std::vector<int>& GetSubgoals() const { return m_Subgoals; }
+		size_t GetNrOfEdges() const;
+
+		// the preprocessing can be saved next to the grid it was built for, Load skips Build for that same grid.
+		// Load returns false when the file has no subgoal graph for a grid of this size
+		void Save(BinaryFileWriter& file) const;
+		bool Load(const BinaryFileView& file);
+
+	private:
+		struct Edge
+		{
+			int to = -1; // subgoal id, not a node index
+			float cost = 0.f;
+		};
+
+		static constexpr uint32_t FileSizeId = CompileTimeLiteralStringHash("SubgoalGraphSize");
+		static constexpr uint32_t FileSubgoalsId = CompileTimeLiteralStringHash("SubgoalGraphSubgoals");
+		static constexpr uint32_t FileEdgeStartsId = CompileTimeLiteralStringHash("SubgoalGraphEdgeStarts");
+		static constexpr uint32_t FileEdgesId = CompileTimeLiteralStringHash("SubgoalGraphEdges");
+
+		struct NodeRecord
+		{
+			int parent = -1;
+			float costSoFar = 0.f;
+			bool isOpen = false;
+			bool isClosed = false;
+		};
+
+		GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* m_pGraph;
+		Heuristic m_HeuristicFunction;
+
+		std::vector<int> m_Subgoals; // node index of every subgoal
+		std::vector<int> m_SubgoalIds; // indexed by node index, -1 if the node isn't a subgoal
+		std::vector<std::vector<Edge>> m_Edges; // indexed by subgoal id
+		uint64_t m_GraphVersion = 0; // version of the grid's change journal the subgoals were built for
+		bool m_IsUniformCost = true;
+
+		bool HasUniformCost() const;
+
+		bool IsSubgoal(int col, int row) const;
+		float GetHeuristicCost(int fromIdx, int toIdx) const;
+
+		// cells are given relative to the source of the quadrant, returns true if the move can be part of an h-path
+		bool IsHPathMove(int a, int b, int fromA, int fromB) const;
+
+		/// <summary>
+		/// fills in the cost of every cell in one quadrant around the source that can be reached over an h-path
+		/// </summary>
+		/// <param name="fromIdx">source node index</param>
+		/// <param name="horDir">horizontal side of the quadrant +1 or -1</param>
+		/// <param name="verDir">vertical side of the quadrant +1 or -1</param>
+		/// <param name="width">amount of columns to look at, including the one of the source</param>
+		/// <param name="height">amount of rows to look at, including the one of the source</param>
+		/// <param name="isStoppingAtSubgoals">subgoals get a cost but paths don't continue through them</param>
+		/// <param name="costs">costs row by row, negative for cells that can't be reached, stops after the last reachable row</param>
+		void ExploreQuadrant(
+			int fromIdx,
+			int horDir,
+			int verDir,
+			int width,
+			int height,
+			bool isStoppingAtSubgoals,
+			std::vector<float>& costs) const;
+
+		// collects the subgoals that can be reached from the node without passing another subgoal
+		std::vector<Edge> GetDirectHReachableSubgoals(int fromIdx) const;
+
+		// appends the cells of an h-path after the start node, returns false if the nodes aren't h-reachable
+		bool AppendHReachablePath(int fromIdx, int toIdx, std::vector<T_NodeType*>& path) const;
+	};
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::SubgoalGraph(
+		GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph,
+		Heuristic hFunction)
+		: m_pGraph(pGraph)
+		, m_HeuristicFunction(hFunction)
+	{
+		Build();
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::Build(const ProgressCallback& progress)
+	{
+		m_Subgoals.clear();
+		m_SubgoalIds.assign(m_pGraph->GetNrOfNodes(), -1);
+		m_Edges.clear();
+
+		// every row collects its own subgoals, appending them row by row keeps the ids in scan order
+		std::vector<std::vector<int>> subgoalsPerRow(m_pGraph->GetRows());
+		ParallelFor(0, m_pGraph->GetRows(), 16, [this, &subgoalsPerRow](int firstRow, int lastRow)
+		{
+			for (int row = firstRow; row < lastRow; ++row)
+			{
+				for (int col = 0; col < m_pGraph->GetColumns(); ++col)
+				{
+					if (IsSubgoal(col, row))
+						subgoalsPerRow[row].push_back(m_pGraph->GetIndex(col, row));
+				}
+			}
+		});
+
+		for (const auto& rowSubgoals : subgoalsPerRow)
+		{
+			for (int idx : rowSubgoals)
+			{
+				m_SubgoalIds[idx] = int(m_Subgoals.size());
+				m_Subgoals.push_back(idx);
+			}
+		}
+
+		m_Edges.resize(m_Subgoals.size());
+		ParallelFor(0, int(m_Subgoals.size()), 32, [this](int firstId, int lastId)
+		{
+			for (int id = firstId; id < lastId; ++id)
+				m_Edges[id] = GetDirectHReachableSubgoals(m_Subgoals[id]);
+		}, progress);
+
+		m_IsUniformCost = HasUniformCost();
+		m_GraphVersion = m_pGraph->GetChangeJournal().GetVersion();
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	bool SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::Update()
+	{
+		if (IsUpToDate())
+			return false;
+
+		Build();
+		return true;
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::Save(BinaryFileWriter& file) const
+	{
+		const int32_t size[2]{ m_pGraph->GetColumns(), m_pGraph->GetRows() };
+		file.AddSection(FileSizeId, size, 2);
+		file.AddSection(FileSubgoalsId, m_Subgoals);
+
+		// the edges of subgoal id are edges[edgeStarts[id]..edgeStarts[id + 1]]
+		std::vector<uint32_t> edgeStarts{ 0 };
+		std::vector<Edge> edges;
+		for (const auto& subgoalEdges : m_Edges)
+		{
+			edges.insert(edges.end(), subgoalEdges.begin(), subgoalEdges.end());
+			edgeStarts.push_back(uint32_t(edges.size()));
+		}
+		file.AddSection(FileEdgeStartsId, edgeStarts);
+		file.AddSection(FileEdgesId, edges);
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	bool SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::Load(const BinaryFileView& file)
+	{
+		size_t nrOfSizes = 0, nrOfSubgoals = 0, nrOfEdgeStarts = 0, nrOfEdges = 0;
+		const int32_t* pSize = file.GetSection<int32_t>(FileSizeId, nrOfSizes);
+		const int* pSubgoals = file.GetSection<int>(FileSubgoalsId, nrOfSubgoals);
+		const uint32_t* pEdgeStarts = file.GetSection<uint32_t>(FileEdgeStartsId, nrOfEdgeStarts);
+		const Edge* pEdges = file.GetSection<Edge>(FileEdgesId, nrOfEdges);
+		if (!pSize || nrOfSizes != 2 || pSize[0] != m_pGraph->GetColumns() || pSize[1] != m_pGraph->GetRows()
+			|| !pSubgoals || !pEdgeStarts || !pEdges || nrOfEdgeStarts != nrOfSubgoals + 1 || pEdgeStarts[nrOfSubgoals] != nrOfEdges)
+			return false;
+
+		// the ids in the file are trusted after this
+		for (size_t id = 0; id < nrOfSubgoals; ++id)
+		{
+			if (pSubgoals[id] < 0 || pSubgoals[id] >= m_pGraph->GetNrOfNodes() || pEdgeStarts[id] > pEdgeStarts[id + 1])
+				return false;
+		}
+		for (size_t i = 0; i < nrOfEdges; ++i)
+		{
+			if (pEdges[i].to < 0 || pEdges[i].to >= int(nrOfSubgoals))
+				return false;
+		}
+
+		m_Subgoals.assign(pSubgoals, pSubgoals + nrOfSubgoals);
+		m_SubgoalIds.assign(m_pGraph->GetNrOfNodes(), -1);
+		m_Edges.resize(nrOfSubgoals);
+		for (size_t id = 0; id < nrOfSubgoals; ++id)
+		{
+			m_SubgoalIds[m_Subgoals[id]] = int(id);
+			m_Edges[id].assign(pEdges + pEdgeStarts[id], pEdges + pEdgeStarts[id + 1]);
+		}
+
+		// the file belongs to the grid as it is now
+		m_IsUniformCost = HasUniformCost();
+		m_GraphVersion = m_pGraph->GetChangeJournal().GetVersion();
+		return true;
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	std::vector<T_NodeType*> SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::FindPath(
+		T_NodeType* pStartNode,
+		T_NodeType* pGoalNode)
+	{
+		const int startIdx = pStartNode->GetIndex();
+		const int goalIdx = pGoalNode->GetIndex();
+
+		std::vector<T_NodeType*> path{ pStartNode };
+		if (startIdx == goalIdx || !m_pGraph->AreConnected(startIdx, goalIdx) || AppendHReachablePath(startIdx, goalIdx, path))
+			return path;
+
+		// the start and goal get the last two ids of the subgoal graph for the duration of the query
+		const int startId = int(m_Subgoals.size());
+		const int goalId = startId + 1;
+		auto getNodeIdx = [this, startId, startIdx, goalIdx](int id)
+		{
+			if (id < startId)
+				return m_Subgoals[id];
+			return id == startId ? startIdx : goalIdx;
+		};
+
+		// the graph is undirected, so the subgoals that can reach the goal are the ones the goal can reach
+		std::vector<float> costsToGoal(m_Subgoals.size(), -1.f);
+		for (const Edge& edge : GetDirectHReachableSubgoals(goalIdx))
+			costsToGoal[edge.to] = edge.cost;
+
+		std::vector<NodeRecord> records(goalId + 1);
+		using OpenEntry = std::pair<float, int>;
+		std::priority_queue<OpenEntry, std::vector<OpenEntry>, std::greater<OpenEntry>> openList{};
+
+		records[startId].isOpen = true;
+		openList.emplace(GetHeuristicCost(startIdx, goalIdx), startId);
+
+		const std::vector<Edge> startEdges = GetDirectHReachableSubgoals(startIdx);
+
+		while (!openList.empty())
+		{
+			const int currentId = openList.top().second;
+			openList.pop();
+
+			NodeRecord& currentRecord = records[currentId];
+			if (currentRecord.isClosed)
+				continue;
+
+			currentRecord.isOpen = false;
+			currentRecord.isClosed = true;
+
+			if (currentId == goalId)
+				break;
+
+			auto relax = [&](int toId, float cost)
+			{
+				NodeRecord& toRecord = records[toId];
+				const float costSoFar = currentRecord.costSoFar + cost;
+				if (toRecord.isClosed || (toRecord.isOpen && costSoFar >= toRecord.costSoFar))
+					return;
+
+				toRecord.parent = currentId;
+				toRecord.costSoFar = costSoFar;
+				toRecord.isOpen = true;
+				openList.emplace(costSoFar + GetHeuristicCost(getNodeIdx(toId), goalIdx), toId);
+			};
+
+			for (const Edge& edge : currentId == startId ? startEdges : m_Edges[currentId])
+				relax(edge.to, edge.cost);
+
+			if (currentId != startId && costsToGoal[currentId] >= 0.f)
+				relax(goalId, costsToGoal[currentId]);
+		}
+
+		if (!records[goalId].isClosed)
+			return path;
+
+		// walk back over the subgoals, then refine every h-reachable segment into cells
+		std::vector<int> subgoalPath{};
+		for (int id = goalId; id != -1; id = records[id].parent)
+			subgoalPath.push_back(getNodeIdx(id));
+
+		std::reverse(subgoalPath.begin(), subgoalPath.end());
+		for (size_t i = 1; i < subgoalPath.size(); ++i)
+			AppendHReachablePath(subgoalPath[i - 1], subgoalPath[i], path);
+
+		return path;
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	size_t SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetNrOfEdges() const
+	{
+		size_t nrOfEdges = 0;
+		for (const auto& edges : m_Edges)
+			nrOfEdges += edges.size();
+
+		return nrOfEdges;
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	bool SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::HasUniformCost() const
+	{
+		// water isn't walkable, it's an obstacle like any other
+		for (int idx = 0; idx < m_pGraph->GetNrOfNodes(); ++idx)
+		{
+			const float terrainCost = GetTerrainCost(m_pGraph->GetNode(idx));
+			if (terrainCost != float(TerrainType::Ground) && terrainCost < float(TerrainType::Water))
+				return false;
+		}
+
+		return true;
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	bool SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::IsSubgoal(int col, int row) const
+	{
+		if (!m_pGraph->IsWalkable(col, row))
+			return false;
+
+		for (int verDir = -1; verDir <= 1; verDir += 2)
+		{
+			for (int horDir = -1; horDir <= 1; horDir += 2)
+			{
+				const int diagonalCol = col + horDir;
+				const int diagonalRow = row + verDir;
+				const bool isInGrid = diagonalCol >= 0 && diagonalCol < m_pGraph->GetColumns()
+					&& diagonalRow >= 0 && diagonalRow < m_pGraph->GetRows();
+
+				if (!isInGrid)
+					continue;
+
+				// convex corner: the diagonal cell is blocked while both cells next to it are free
+				if (!m_pGraph->IsWalkable(diagonalCol, diagonalRow)
+					&& m_pGraph->IsWalkable(diagonalCol, row)
+					&& m_pGraph->IsWalkable(col, diagonalRow))
+					return true;
+
+				// cutting the corner: paths squeeze diagonally past a blocked side
+				if (T_MovementPolicy::IsCornerCuttingAllowed
+					&& m_pGraph->IsWalkable(diagonalCol, diagonalRow)
+					&& (!m_pGraph->IsWalkable(diagonalCol, row) || !m_pGraph->IsWalkable(col, diagonalRow)))
+					return true;
+			}
+		}
+
+		return false;
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	float SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetHeuristicCost(int fromIdx, int toIdx) const
+	{
+		Vector2 toDestination = m_pGraph->GetNodePos(toIdx) - m_pGraph->GetNodePos(fromIdx);
+		return m_HeuristicFunction(abs(toDestination.x), abs(toDestination.y));
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::ExploreQuadrant(
+		int fromIdx,
+		int horDir,
+		int verDir,
+		int width,
+		int height,
+		bool isStoppingAtSubgoals,
+		std::vector<float>& costs) const
+	{
+		costs.assign(width, -1.f);
+		costs[0] = 0.f;
+
+		const int fromCol = fromIdx % m_pGraph->GetColumns();
+		const int fromRow = fromIdx / m_pGraph->GetColumns();
+
+		// a cell can pass on its path when it's reachable and not a subgoal that ends the path
+		auto canContinueFrom = [&](int a, int b)
+		{
+			if (costs[b * width + a] < 0.f)
+				return false;
+			return !isStoppingAtSubgoals || (a == 0 && b == 0)
+				|| m_SubgoalIds[m_pGraph->GetIndex(fromCol + a * horDir, fromRow + b * verDir)] == -1;
+		};
+
+		auto tryMove = [&](int a, int b, int fromA, int fromB)
+		{
+			if (!canContinueFrom(fromA, fromB))
+				return;
+
+			const auto pConnection = m_pGraph->GetConnection(
+				m_pGraph->GetIndex(fromCol + fromA * horDir, fromRow + fromB * verDir),
+				m_pGraph->GetIndex(fromCol + a * horDir, fromRow + b * verDir));
+
+			if (!pConnection)
+				return;
+
+			// every h-path to a cell costs the same on uniform grids, so the first one found is as good as any
+			if (costs[b * width + a] < 0.f)
+				costs[b * width + a] = costs[fromB * width + fromA] + pConnection->GetCost();
+		};
+
+		for (int b = 0; b < height; ++b)
+		{
+			if (b > 0)
+				costs.resize((b + 1) * width, -1.f);
+
+			bool isRowReachable = b == 0;
+
+			for (int a = 0; a < width; ++a)
+			{
+				if (a == 0 && b == 0)
+					continue;
+
+				if (IsHPathMove(a, b, a - 1, b - 1))
+					tryMove(a, b, a - 1, b - 1);
+				if (IsHPathMove(a, b, a - 1, b))
+					tryMove(a, b, a - 1, b);
+				if (IsHPathMove(a, b, a, b - 1))
+					tryMove(a, b, a, b - 1);
+
+				isRowReachable |= costs[b * width + a] >= 0.f;
+			}
+
+			// every cell needs a reachable cell in the row before it
+			if (!isRowReachable)
+				return;
+		}
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	bool SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::IsHPathMove(int a, int b, int fromA, int fromB) const
+	{
+		if (fromA < 0 || fromB < 0)
+			return false;
+
+		// only moves that take us closer in the heuristic are allowed
+		// with diagonals the straight moves have to go along the longest axis
+		if (fromA != a && fromB != b)
+			return T_MovementPolicy::IsDiagonalAllowed;
+		if (!T_MovementPolicy::IsDiagonalAllowed)
+			return true;
+
+		return fromA != a ? a > b : b > a;
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	std::vector<typename SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::Edge>
+	SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::GetDirectHReachableSubgoals(int fromIdx) const
+	{
+		std::vector<Edge> edges{};
+		std::vector<float> costs{};
+
+		const int fromCol = fromIdx % m_pGraph->GetColumns();
+		const int fromRow = fromIdx / m_pGraph->GetColumns();
+
+		for (int verDir = -1; verDir <= 1; verDir += 2)
+		{
+			for (int horDir = -1; horDir <= 1; horDir += 2)
+			{
+				const int width = horDir > 0 ? m_pGraph->GetColumns() - fromCol : fromCol + 1;
+				const int height = verDir > 0 ? m_pGraph->GetRows() - fromRow : fromRow + 1;
+				ExploreQuadrant(fromIdx, horDir, verDir, width, height, true, costs);
+
+				for (int b = 0; b < int(costs.size()) / width; ++b)
+				{
+					for (int a = 0; a < width; ++a)
+					{
+						// the cells on the axes belong to two quadrants, only take them once
+						if (costs[b * width + a] <= 0.f || (a == 0 && horDir < 0) || (b == 0 && verDir < 0))
+							continue;
+
+						const int subgoalId = m_SubgoalIds[m_pGraph->GetIndex(fromCol + a * horDir, fromRow + b * verDir)];
+						if (subgoalId != -1)
+							edges.push_back(Edge{ subgoalId, costs[b * width + a] });
+					}
+				}
+			}
+		}
+
+		return edges;
+	}
+
+	template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	bool SubgoalGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>::AppendHReachablePath(
+		int fromIdx,
+		int toIdx,
+		std::vector<T_NodeType*>& path) const
+	{
+		const int columns = m_pGraph->GetColumns();
+		const int fromCol = fromIdx % columns;
+		const int fromRow = fromIdx / columns;
+		const int deltaCol = toIdx % columns - fromCol;
+		const int deltaRow = toIdx / columns - fromRow;
+		const int horDir = deltaCol < 0 ? -1 : 1;
+		const int verDir = deltaRow < 0 ? -1 : 1;
+		const int width = abs(deltaCol) + 1;
+		const int height = abs(deltaRow) + 1;
+
+		std::vector<float> costs{};
+		ExploreQuadrant(fromIdx, horDir, verDir, width, height, false, costs);
+
+		if (int(costs.size()) != width * height || costs.back() < 0.f)
+			return false;
+
+		// walk back from the goal over any reachable cell we could have come from
+		const size_t startSize = path.size();
+		int a = width - 1;
+		int b = height - 1;
+		while (a != 0 || b != 0)
+		{
+			const int idx = m_pGraph->GetIndex(fromCol + a * horDir, fromRow + b * verDir);
+			path.push_back(m_pGraph->GetNode(idx));
+
+			auto isPredecessor = [&](int fromA, int fromB)
+			{
+				return IsHPathMove(a, b, fromA, fromB) && costs[fromB * width + fromA] >= 0.f
+					&& m_pGraph->GetConnection(m_pGraph->GetIndex(fromCol + fromA * horDir, fromRow + fromB * verDir), idx);
+			};
+
+			if (isPredecessor(a - 1, b - 1))
+			{
+				--a;
+				--b;
+			}
+			else if (isPredecessor(a - 1, b))
+				--a;
+			else
+				--b;
+		}
+
+		std::reverse(path.begin() + startSize, path.end());
+		return true;
+	}
+}
@@ -2,7 +2,7 @@
 #include "EGraphEditor.h"
 
 
-bool Elite::EGraphEditor::UpdateGraph(GridGraph<GridTerrainNode, GraphConnection>* pGraph)
+void Elite::EGraphEditor::UpdateTerrainUI()
 {
 #pragma region UI
 	//Extra Grid Terrain UI
@@ -23,6 +23,12 @@ bool Elite::EGraphEditor::UpdateGraph(GridGraph<GridTerrainNode, GraphConnection
 		{
 
 		}
+		ImGui::Unindent();
+
+		ImGui::Text("Brush Size");
+		ImGui::Indent();
+		ImGui::SliderInt("##BrushSize", &m_BrushSize, 1, 15);
+		ImGui::Unindent();
 		
 		/*Spacing*/ImGui::Spacing(); ImGui::Separator(); ImGui::Spacing(); ImGui::Spacing();
 
@@ -31,35 +37,4 @@ bool Elite::EGraphEditor::UpdateGraph(GridGraph<GridTerrainNode, GraphConnection
 		ImGui::End();
 	}
 #pragma endregion
-
-
-	//Check if clicked on grid
-	auto mouseLeftData = INPUTMANAGER->GetMouseData(Elite::InputType::eMouseButton, Elite::InputMouseButton::eLeft);
-	auto mouseMotionData = INPUTMANAGER->GetMouseData(Elite::InputType::eMouseMotion);
-
-	if (INPUTMANAGER->IsMouseButtonUp(InputMouseButton::eLeft))
-	{
-		Vector2 mousePos = DEBUGRENDERER2D->GetActiveCamera()->ConvertScreenToWorld({ (float)mouseLeftData.X, (float)mouseLeftData.Y });
-		int idx = pGraph->GetNodeIdxAtWorldPos(mousePos);
-		
-		if (idx != invalid_node_index)
-		{
-			std::vector<TerrainType> terrainTypeVec{ TerrainType::Ground, TerrainType::Mud, TerrainType::Water };
-
-			pGraph->GetNode(idx)->SetTerrainType(terrainTypeVec[m_SelectedTerrainType]);
-			
-			switch (terrainTypeVec[m_SelectedTerrainType])
-			{
-			case TerrainType::Water:
-				pGraph->RemoveConnectionsToAdjacentNodes(idx);
-				break;
-			default:
-				pGraph->AddConnectionsToAdjacentCells(idx);
-				break;
-			}
-			return true;
-		}
-	}
-
-	return false;
 }
@@ -13,17 +13,55 @@ namespace Elite
 		EGraphEditor() = default;
 		~EGraphEditor() = default;
 		 
-		bool UpdateGraph(GridGraph<GridTerrainNode, GraphConnection>* pGraph);
+		template <class T_MovementPolicy>
+		bool UpdateGraph(GridGraph<GridTerrainNode, GraphConnection, T_MovementPolicy>* pGraph) { return UpdateTerrainGraph(pGraph); }
 
-		template <class T_NodeType, class T_ConnectionType>
-		bool UpdateGraph(GridGraph<T_NodeType, T_ConnectionType>* pGraph);
+		template <class T_MovementPolicy>
+		bool UpdateGraph(GridGraph<CompactGridNode, CompactGraphConnection, T_MovementPolicy>* pGraph) { return UpdateTerrainGraph(pGraph); }
+
+		template <class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+		bool UpdateGraph(GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph);
 	private:
 		int m_SelectedTerrainType = (int)TerrainType::Ground;
-		
+		int m_BrushSize = 1;
+
+		void UpdateTerrainUI();
+
+		template <class T_GridGraph>
+		bool UpdateTerrainGraph(T_GridGraph* pGraph);
 	};
+
+	template<class T_GridGraph>
+	inline bool EGraphEditor::UpdateTerrainGraph(T_GridGraph* pGraph)
+	{
+		UpdateTerrainUI();
+
+		//Check if clicked on grid
+		auto mouseLeftData = INPUTMANAGER->GetMouseData(Elite::InputType::eMouseButton, Elite::InputMouseButton::eLeft);
+		auto mouseMotionData = INPUTMANAGER->GetMouseData(Elite::InputType::eMouseMotion);
+
+		if (INPUTMANAGER->IsMouseButtonUp(InputMouseButton::eLeft))
+		{
+			Vector2 mousePos = DEBUGRENDERER2D->GetActiveCamera()->ConvertScreenToWorld({ (float)mouseLeftData.X, (float)mouseLeftData.Y });
+			int idx = pGraph->GetNodeIdxAtWorldPos(mousePos);
+
+			if (idx != invalid_node_index)
+			{
+				std::vector<TerrainType> terrainTypeVec{ TerrainType::Ground, TerrainType::Mud, TerrainType::Water };
+
+				// The brush is a square of cells centered on the clicked cell, painted in one go
+				auto colRow = pGraph->GetNodePos(idx);
+				int offset = (m_BrushSize - 1) / 2;
+				pGraph->SetTerrainRegion((int)colRow.x - offset, (int)colRow.y - offset, m_BrushSize, m_BrushSize, terrainTypeVec[m_SelectedTerrainType]);
+				return true;
+			}
+		}
+
+		return false;
+	}
 	
-	template<class T_NodeType, class T_ConnectionType>
-	inline bool EGraphEditor::UpdateGraph(GridGraph<T_NodeType, T_ConnectionType>* pGraph)
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	inline bool EGraphEditor::UpdateGraph(GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph)
 	{
 		//Check if clicked on grid
 
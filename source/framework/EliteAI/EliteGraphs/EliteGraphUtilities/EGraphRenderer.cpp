@@ -28,7 +28,7 @@ namespace Elite
 
 	
 
-	void EGraphRenderer::RenderConnection(GraphConnection* con, Elite::Vector2 toPos, Elite::Vector2 fromPos, std::string text, Elite::Color col, float depth/*= 0.0f*/) const
+	void EGraphRenderer::RenderConnection(Elite::Vector2 toPos, Elite::Vector2 fromPos, std::string text, Elite::Color col, float depth/*= 0.0f*/) const
 	{
 		auto center = toPos + (fromPos - toPos) / 2;
 
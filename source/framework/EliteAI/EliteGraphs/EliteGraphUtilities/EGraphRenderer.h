@@ -18,21 +18,21 @@ namespace Elite
 		template<class T_NodeType, class T_ConnectionType>
 		void RenderGraph(IGraph<T_NodeType, T_ConnectionType>* pGraph, bool renderNodes, bool renderConnections, bool renderNodeTxt = true, bool renderConnectionTxt = true) const;
 
-		template<class T_NodeType, class T_ConnectionType>
-		void RenderGraph(GridGraph<T_NodeType, T_ConnectionType>* pGraph, bool renderNodes, bool renderNodeTxt, bool renderConnections, bool renderConnectionsCosts) const;
+		template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+		void RenderGraph(GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph, bool renderNodes, bool renderNodeTxt, bool renderConnections, bool renderConnectionsCosts) const;
 
 		template<class T_NodeType>
 		void RenderHighlighted(std::vector<T_NodeType*> path, Color col = HIGHLIGHTED_NODE_COLOR) const;
 
-		template<class T_NodeType, class T_ConnectionType>
-		void RenderHighlightedGrid(GridGraph<T_NodeType, T_ConnectionType>* pGraph, std::vector<T_NodeType*> path, Color col = HIGHLIGHTED_NODE_COLOR) const;
+		template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+		void RenderHighlightedGrid(GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph, std::vector<T_NodeType*> path, Color col = HIGHLIGHTED_NODE_COLOR) const;
 
 		void SetNumberPrintPrecision(int precision) { m_FloatPrintPrecision = precision; }
 
 	private:
 		void RenderCircleNode(Vector2 pos, std::string text = "", float radius = DEFAULT_NODE_RADIUS, Elite::Color col = DEFAULT_NODE_COLOR, float depth = 0.0f) const;
 		void RenderRectNode(Vector2 pos, std::string text = "", float width = DEFAULT_NODE_RADIUS, Elite::Color col = DEFAULT_NODE_COLOR, float depth = 0.0f) const;
-		void RenderConnection(GraphConnection* con, Elite::Vector2 toPos, Elite::Vector2 fromPos, std::string text, Elite::Color col = DEFAULT_CONNECTION_COLOR, float depth = 0.0f) const;
+		void RenderConnection(Elite::Vector2 toPos, Elite::Vector2 fromPos, std::string text, Elite::Color col = DEFAULT_CONNECTION_COLOR, float depth = 0.0f) const;
 
 		// Get correct color/text depending on the pNode/pConnection type
 		template<class T_NodeType, typename = typename enable_if<! is_base_of<GraphNode2D, T_NodeType>::value>::type>
@@ -94,7 +94,7 @@ namespace Elite
 						conTxt = ss.str();
 					}
 
-					RenderConnection(con,
+					RenderConnection(
 						pGraph->GetNodeWorldPos(con->GetTo()),
 						pGraph->GetNodeWorldPos(con->GetFrom()),
 						conTxt,
@@ -105,9 +105,9 @@ namespace Elite
 		}
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
 	void EGraphRenderer::RenderGraph(
-		GridGraph<T_NodeType, T_ConnectionType>* pGraph, 
+		GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph, 
 		bool renderNodes, 
 		bool renderNodeNumbers,
 		bool renderConnections, 
@@ -161,7 +161,7 @@ namespace Elite
 						ss << std::fixed << std::setprecision(m_FloatPrintPrecision) << con->GetCost();
 						text = ss.str();
 					}
-					RenderConnection(con,
+					RenderConnection(
 						pGraph->GetNodeWorldPos(con->GetTo()),
 						pGraph->GetNodeWorldPos(con->GetFrom()),
 						text
@@ -187,8 +187,8 @@ namespace Elite
 		}
 	}
 
-	template<class T_NodeType, class T_ConnectionType>
-	void EGraphRenderer::RenderHighlightedGrid(GridGraph<T_NodeType, T_ConnectionType>* pGraph, std::vector<T_NodeType*> path, Color col /*= HIGHLIGHTED_NODE_COLOR*/) const
+	template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+	void EGraphRenderer::RenderHighlightedGrid(GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph, std::vector<T_NodeType*> path, Color col /*= HIGHLIGHTED_NODE_COLOR*/) const
 	{
 		for (auto node : path)
 		{
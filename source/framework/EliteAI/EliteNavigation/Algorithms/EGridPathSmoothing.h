@@ -0,0 +1,104 @@
+#pragma once
+
+#include <vector>
+#include "framework/EliteAI/EliteGraphs/EGridGraph.h"
+
+namespace Elite
+{
+	// Post processing for cell by cell grid paths (AStar, BFS, JumpPointSearch)
+	// the navmesh version of this lives in EPathSmoothing.h (SSFA)
+	class GridPathSmoothing final
+	{
+	public:
+		//=== Grid Path Smoothing Functions ===
+		//--- References ---
+		//http://www.cse.yorku.ca/~amana/research/grid.pdf
+		//https://www.gamedeveloper.com/programming/toward-more-realistic-pathfinding
+
+		// String pulling: skips every node that can be reached in a straight line from the last kept one
+		template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+		static std::vector<T_NodeType*> SmoothPath(
+			const GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph,
+			const std::vector<T_NodeType*>& path)
+		{
+			if (path.size() < 3)
+				return path;
+
+			std::vector<T_NodeType*> vWaypoints = {};
+			vWaypoints.push_back(path.front());
+
+			for (size_t i = 2; i < path.size(); ++i)
+			{
+				if (!HasLineOfSight(pGraph, vWaypoints.back(), path[i]))
+					vWaypoints.push_back(path[i - 1]);
+			}
+
+			vWaypoints.push_back(path.back());
+			return vWaypoints;
+		}
+
+		// Walks every cell the line between both cell centers touches (supercover line)
+		// blocked cells and cells with a different terrain cost than the start break the line of sight,
+		// so a smoothed path never cuts through mud the pathfinder went around
+		template<class T_NodeType, class T_ConnectionType, class T_MovementPolicy>
+		static bool HasLineOfSight(
+			const GridGraph<T_NodeType, T_ConnectionType, T_MovementPolicy>* pGraph,
+			const T_NodeType* pFromNode,
+			const T_NodeType* pToNode)
+		{
+			const int columns = pGraph->GetColumns();
+			int col = pFromNode->GetIndex() % columns;
+			int row = pFromNode->GetIndex() / columns;
+			const int toCol = pToNode->GetIndex() % columns;
+			const int toRow = pToNode->GetIndex() / columns;
+
+			const float terrainCost = GetTerrainCost(pFromNode);
+			auto isCellOpen = [pGraph, terrainCost](int c, int r)
+			{
+				return pGraph->IsWalkable(c, r) && GetTerrainCost(pGraph->GetNode(c, r)) == terrainCost;
+			};
+
+			const int horDir = (toCol > col) - (toCol < col);
+			const int verDir = (toRow > row) - (toRow < row);
+			const int deltaCol = abs(toCol - col);
+			const int deltaRow = abs(toRow - row);
+
+			// error > 0 means the line leaves the cell through the vertical side, < 0 through the horizontal side
+			int error = deltaCol - deltaRow;
+
+			while (col != toCol || row != toRow)
+			{
+				if (error > 0)
+				{
+					col += horDir;
+					error -= 2 * deltaRow;
+				}
+				else if (error < 0)
+				{
+					row += verDir;
+					error += 2 * deltaCol;
+				}
+				else
+				{
+					// the line goes exactly through a corner, the two cells next to it are only touched at that point
+					if (!T_MovementPolicy::IsCornerCuttingAllowed
+						&& (!isCellOpen(col + horDir, row) || !isCellOpen(col, row + verDir)))
+						return false;
+
+					col += horDir;
+					row += verDir;
+					error += 2 * (deltaCol - deltaRow);
+				}
+
+				if (!isCellOpen(col, row))
+					return false;
+			}
+
+			return true;
+		}
+
+	private:
+		GridPathSmoothing() {};
+		~GridPathSmoothing() {};
+	};
+}
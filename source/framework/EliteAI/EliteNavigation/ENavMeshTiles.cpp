@@ -0,0 +1,398 @@
+#include "stdafx.h"
+#include "ENavMeshTiles.h"
+
+using namespace Elite;
+
+namespace
+{
+	//Points closer than this to an edge are on it
+	const float OnEdgeDistance = 1e-4f;
+
+	struct TileEdge
+	{
+		Vector2 p1;
+		Vector2 p2;
+		int shapeIdx;
+		bool isInsideLeft; //The inside of the shape is on the left of p1 to p2
+		std::vector<Vector2> splits;
+	};
+
+	bool IsLess(const Vector2& a, const Vector2& b)
+	{ return a.x < b.x || (a.x == b.x && a.y < b.y); }
+
+	//Ray crossing test, the result for points exactly on an edge can go either way
+	bool IsPointInShape(const Vector2& p, const std::vector<Vector2>& shape)
+	{
+		auto isInside = false;
+		for (size_t i = 0, j = shape.size() - 1; i < shape.size(); j = i++)
+		{
+			const auto& a = shape[i];
+			const auto& b = shape[j];
+			if ((a.y > p.y) != (b.y > p.y) && p.x < (b.x - a.x) * (p.y - a.y) / (b.y - a.y) + a.x)
+				isInside = !isInside;
+		}
+		return isInside;
+	}
+
+	bool IsPointOnEdge(const Vector2& p, const TileEdge& edge)
+	{
+		const auto dir = edge.p2 - edge.p1;
+		const auto lengthSquared = dir.MagnitudeSquared();
+		const auto t = Dot(p - edge.p1, dir) / lengthSquared;
+		const auto cross = Cross(dir, p - edge.p1);
+		return t > 0.f && t < 1.f && cross * cross <= OnEdgeDistance * OnEdgeDistance * lengthSquared;
+	}
+
+	void AddSplitIfOnEdge(const Vector2& p, TileEdge& edge)
+	{
+		if (p != edge.p1 && p != edge.p2 && IsPointOnEdge(p, edge))
+			edge.splits.push_back(p);
+	}
+
+	//Every intersection is calculated once and added to both edges, so they get split at the exact same point
+	void AddIntersections(TileEdge& e1, TileEdge& e2)
+	{
+		AddSplitIfOnEdge(e1.p1, e2);
+		AddSplitIfOnEdge(e1.p2, e2);
+		AddSplitIfOnEdge(e2.p1, e1);
+		AddSplitIfOnEdge(e2.p2, e1);
+
+		const auto r = e1.p2 - e1.p1;
+		const auto s = e2.p2 - e2.p1;
+		const auto denominator = Cross(r, s);
+		if (denominator == 0.f)
+			return;
+
+		const auto t = Cross(e2.p1 - e1.p1, s) / denominator;
+		const auto u = Cross(e2.p1 - e1.p1, r) / denominator;
+		if (t <= 0.f || t >= 1.f || u <= 0.f || u >= 1.f)
+			return;
+
+		//Edges touching at an end point were handled above. On a horizontal or vertical edge, like the border of a tile,
+		//the intersection is put exactly on the edge so the neighbouring tile finds the same point
+		auto p = e1.p1 + r * t;
+		for (const auto* pEdge : { &e1, &e2 })
+		{
+			if (pEdge->p1.x == pEdge->p2.x)
+				p.x = pEdge->p1.x;
+			if (pEdge->p1.y == pEdge->p2.y)
+				p.y = pEdge->p1.y;
+		}
+		for (const auto& end : { e1.p1, e1.p2, e2.p1, e2.p2 })
+		{
+			if (DistanceSquared(p, end) <= OnEdgeDistance * OnEdgeDistance)
+				return;
+		}
+		e1.splits.push_back(p);
+		e2.splits.push_back(p);
+	}
+}
+
+Elite::NavMeshTiles::NavMeshTiles(const Polygon& contour, float tileSize)
+{
+	m_Contour.assign(contour.GetPoints().begin(), contour.GetPoints().end());
+	for (const auto& child : contour.GetChildren())
+		m_ContourHoles.emplace_back(child.GetPoints().begin(), child.GetPoints().end());
+
+	Vector2 min = { (std::numeric_limits<float>::max)(), (std::numeric_limits<float>::max)() };
+	Vector2 max = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	for (const auto& p : m_Contour)
+	{
+		min.x = (std::min)(min.x, p.x);
+		min.y = (std::min)(min.y, p.y);
+		max.x = (std::max)(max.x, p.x);
+		max.y = (std::max)(max.y, p.y);
+	}
+	if (m_Contour.empty())
+		return;
+
+	if (tileSize <= 0.f)
+		tileSize = (std::max)(max.x - min.x, max.y - min.y);
+	m_Columns = (std::max)(1, static_cast<int>(ceilf((max.x - min.x) / tileSize)));
+	m_Rows = (std::max)(1, static_cast<int>(ceilf((max.y - min.y) / tileSize)));
+
+	//Neighbouring tiles get their shared border from the same calculation, the last ones end exactly on the contour
+	auto getBorderX = [&](int c) { return c == m_Columns ? max.x : min.x + c * tileSize; };
+	auto getBorderY = [&](int r) { return r == m_Rows ? max.y : min.y + r * tileSize; };
+
+	m_Tiles.resize(m_Columns * m_Rows);
+	for (auto r = 0; r < m_Rows; ++r)
+	{
+		for (auto c = 0; c < m_Columns; ++c)
+		{
+			auto& tile = m_Tiles[r * m_Columns + c];
+			tile.min = { getBorderX(c), getBorderY(r) };
+			tile.max = { getBorderX(c + 1), getBorderY(r + 1) };
+		}
+	}
+}
+
+int Elite::NavMeshTiles::Update(const std::vector<Polygon>& obstacles)
+{
+	if (m_Tiles.empty())
+		return 0;
+
+	//Bin the obstacles in the tiles that their bounds overlap, touching counts as overlapping
+	std::vector<std::vector<std::vector<Vector2>>> tileObstacles(m_Tiles.size());
+	const auto tileSize = m_Tiles[0].max - m_Tiles[0].min;
+	const auto& origin = m_Tiles[0].min;
+	auto binObstacle = [&](std::vector<Vector2> points)
+	{
+		if (points.size() < 3)
+			return;
+
+		//A point that is only a rounding error away from a tile border would split the border of one tile but not
+		//of its neighbour, put it on the border instead
+		for (auto& p : points)
+		{
+			const int c = Clamp(static_cast<int>(roundf((p.x - origin.x) / tileSize.x)), 0, m_Columns);
+			const auto borderX = c == m_Columns ? m_Tiles[c - 1].max.x : m_Tiles[c].min.x;
+			if (fabsf(p.x - borderX) <= OnEdgeDistance)
+				p.x = borderX;
+
+			const int r = Clamp(static_cast<int>(roundf((p.y - origin.y) / tileSize.y)), 0, m_Rows);
+			const auto borderY = r == m_Rows ? m_Tiles[(r - 1) * m_Columns].max.y : m_Tiles[r * m_Columns].min.y;
+			if (fabsf(p.y - borderY) <= OnEdgeDistance)
+				p.y = borderY;
+		}
+
+		Vector2 min = points[0];
+		Vector2 max = points[0];
+		for (const auto& p : points)
+		{
+			min.x = (std::min)(min.x, p.x);
+			min.y = (std::min)(min.y, p.y);
+			max.x = (std::max)(max.x, p.x);
+			max.y = (std::max)(max.y, p.y);
+		}
+
+		const int minCol = Clamp(static_cast<int>(floorf((min.x - origin.x) / tileSize.x)) - 1, 0, m_Columns - 1);
+		const int maxCol = Clamp(static_cast<int>(floorf((max.x - origin.x) / tileSize.x)) + 1, 0, m_Columns - 1);
+		const int minRow = Clamp(static_cast<int>(floorf((min.y - origin.y) / tileSize.y)) - 1, 0, m_Rows - 1);
+		const int maxRow = Clamp(static_cast<int>(floorf((max.y - origin.y) / tileSize.y)) + 1, 0, m_Rows - 1);
+		for (auto r = minRow; r <= maxRow; ++r)
+		{
+			for (auto c = minCol; c <= maxCol; ++c)
+			{
+				const int tileIdx = r * m_Columns + c;
+				const auto& tile = m_Tiles[tileIdx];
+				if (min.x <= tile.max.x && max.x >= tile.min.x && min.y <= tile.max.y && max.y >= tile.min.y)
+					tileObstacles[tileIdx].push_back(points);
+			}
+		}
+	};
+
+	for (const auto& hole : m_ContourHoles)
+		binObstacle(hole);
+	for (const auto& obstacle : obstacles)
+		binObstacle({ obstacle.GetPoints().begin(), obstacle.GetPoints().end() });
+
+	//Only tiles where the obstacles are different from last time need to be triangulated again
+	auto nrOfRebuiltTiles = 0;
+	for (size_t i = 0; i < m_Tiles.size(); ++i)
+	{
+		auto& tile = m_Tiles[i];
+		if (tile.isBuilt && tile.obstacles == tileObstacles[i])
+			continue;
+
+		tile.obstacles = std::move(tileObstacles[i]);
+		BuildTile(tile);
+		tile.isBuilt = true;
+		++nrOfRebuiltTiles;
+	}
+	return nrOfRebuiltTiles;
+}
+
+std::vector<Triangle> Elite::NavMeshTiles::GetTriangles() const
+{
+	size_t nrOfTriangles = 0;
+	for (const auto& tile : m_Tiles)
+		nrOfTriangles += tile.triangles.size();
+
+	std::vector<Triangle> triangles;
+	triangles.reserve(nrOfTriangles);
+	for (const auto& tile : m_Tiles)
+		triangles.insert(triangles.end(), tile.triangles.begin(), tile.triangles.end());
+	return triangles;
+}
+
+void Elite::NavMeshTiles::BuildTile(Tile& tile) const
+{
+	tile.triangles.clear();
+
+	//1. Everything that can border the walkable area of this tile: the tile itself, the contour and the obstacles
+	std::vector<std::vector<Vector2>> shapes;
+	shapes.push_back({ tile.min, { tile.max.x, tile.min.y }, tile.max, { tile.min.x, tile.max.y } });
+	shapes.push_back(m_Contour);
+	shapes.insert(shapes.end(), tile.obstacles.begin(), tile.obstacles.end());
+
+	//Edges that don't touch the tile can't border it. All edges point the same way, so neighbouring tiles get the same intersections
+	std::vector<TileEdge> edges;
+	for (auto i = 0; i < static_cast<int>(shapes.size()); ++i)
+	{
+		const auto& shape = shapes[i];
+		auto doubleArea = 0.f;
+		for (size_t j = 0; j < shape.size(); ++j)
+			doubleArea += Cross(shape[j], shape[(j + 1) % shape.size()]);
+
+		for (size_t j = 0; j < shape.size(); ++j)
+		{
+			auto p1 = shape[j];
+			auto p2 = shape[(j + 1) % shape.size()];
+			if ((std::max)(p1.x, p2.x) < tile.min.x || (std::min)(p1.x, p2.x) > tile.max.x
+				|| (std::max)(p1.y, p2.y) < tile.min.y || (std::min)(p1.y, p2.y) > tile.max.y || p1 == p2)
+				continue;
+
+			auto isInsideLeft = doubleArea > 0.f;
+			if (IsLess(p2, p1))
+			{
+				std::swap(p1, p2);
+				isInsideLeft = !isInsideLeft;
+			}
+			edges.push_back({ p1, p2, i, isInsideLeft, {} });
+		}
+	}
+
+	//2. Split the edges where they meet edges of other shapes
+	for (size_t i = 0; i < edges.size(); ++i)
+	{
+		for (size_t j = i + 1; j < edges.size(); ++j)
+		{
+			if (edges[i].shapeIdx == edges[j].shapeIdx)
+				continue;
+
+			auto* pE1 = &edges[i];
+			auto* pE2 = &edges[j];
+			if (IsLess(pE2->p1, pE1->p1) || (pE2->p1 == pE1->p1 && IsLess(pE2->p2, pE1->p2)))
+				std::swap(pE1, pE2);
+			AddIntersections(*pE1, *pE2);
+		}
+	}
+
+	//3. A piece of an edge borders the walkable area when that is on one side of it but not on the other,
+	//it is stored with the walkable side on its left. Which side is inside a shape follows from the winding of the shape
+	//when the piece lies on one of its edges, otherwise its center is inside or outside on both sides.
+	//Testing points next to the piece instead would fail on walkable strips thinner than the distance to those points
+	std::vector<bool> isInsideLeft(shapes.size());
+	std::vector<bool> isInsideRight(shapes.size());
+	std::vector<const TileEdge*> collinearEdges;
+	std::vector<std::pair<Vector2, Vector2>> borders;
+	for (auto& edge : edges)
+	{
+		auto& points = edge.splits;
+		points.push_back(edge.p1);
+		points.push_back(edge.p2);
+		const auto dir = edge.p2 - edge.p1;
+		std::sort(points.begin(), points.end(), [&](const Vector2& a, const Vector2& b)
+		{ return Dot(a - edge.p1, dir) < Dot(b - edge.p1, dir); });
+
+		//Edges of other shapes on the same line, the pieces of this edge can lie on top of them
+		collinearEdges.clear();
+		const auto maxCrossSquared = OnEdgeDistance * OnEdgeDistance * dir.MagnitudeSquared();
+		for (const auto& other : edges)
+		{
+			const auto cross1 = Cross(dir, other.p1 - edge.p1);
+			const auto cross2 = Cross(dir, other.p2 - edge.p1);
+			if (other.shapeIdx != edge.shapeIdx && cross1 * cross1 <= maxCrossSquared && cross2 * cross2 <= maxCrossSquared)
+				collinearEdges.push_back(&other);
+		}
+
+		for (size_t i = 0; i + 1 < points.size(); ++i)
+		{
+			const auto& p1 = points[i];
+			const auto& p2 = points[i + 1];
+			if (p1 == p2)
+				continue;
+
+			const auto center = (p1 + p2) / 2.f;
+			for (size_t j = 0; j < shapes.size(); ++j)
+				isInsideLeft[j] = isInsideRight[j] = IsPointInShape(center, shapes[j]);
+			for (const auto* pOther : collinearEdges)
+			{
+				if (IsPointOnEdge(center, *pOther))
+				{
+					const auto isLeft = Dot(pOther->p2 - pOther->p1, dir) > 0.f ? pOther->isInsideLeft : !pOther->isInsideLeft;
+					isInsideLeft[pOther->shapeIdx] = isLeft;
+					isInsideRight[pOther->shapeIdx] = !isLeft;
+				}
+			}
+			isInsideLeft[edge.shapeIdx] = edge.isInsideLeft;
+			isInsideRight[edge.shapeIdx] = !edge.isInsideLeft;
+
+			//Shape 0 is the tile and 1 the contour, the rest are obstacles
+			auto isLeftWalkable = isInsideLeft[0] && isInsideLeft[1];
+			auto isRightWalkable = isInsideRight[0] && isInsideRight[1];
+			for (size_t j = 2; j < shapes.size(); ++j)
+			{
+				isLeftWalkable = isLeftWalkable && !isInsideLeft[j];
+				isRightWalkable = isRightWalkable && !isInsideRight[j];
+			}
+
+			if (isLeftWalkable && !isRightWalkable)
+				borders.emplace_back(p1, p2);
+			else if (isRightWalkable && !isLeftWalkable)
+				borders.emplace_back(p2, p1);
+		}
+	}
+
+	//Edges of different shapes can lie on top of each other
+	auto isLessBorder = [](const std::pair<Vector2, Vector2>& a, const std::pair<Vector2, Vector2>& b)
+	{ return IsLess(a.first, b.first) || (a.first == b.first && IsLess(a.second, b.second)); };
+	std::sort(borders.begin(), borders.end(), isLessBorder);
+	borders.erase(std::unique(borders.begin(), borders.end()), borders.end());
+
+	//4. Chain the borders into shapes. Where shapes touch a point has more borders leaving it,
+	//take the first one clockwise from where we came from so the walkable area stays on the left
+	std::vector<std::vector<Vector2>> walkableShapes;
+	std::vector<bool> isUsed(borders.size(), false);
+	for (size_t start = 0; start < borders.size(); ++start)
+	{
+		if (isUsed[start])
+			continue;
+
+		std::vector<Vector2> shape;
+		auto current = start;
+		while (!isUsed[current])
+		{
+			isUsed[current] = true;
+			shape.push_back(borders[current].first);
+
+			const auto& from = borders[current].first;
+			const auto& at = borders[current].second;
+			const auto backAngle = atan2f(from.y - at.y, from.x - at.x);
+			const auto range = std::equal_range(borders.begin(), borders.end(), std::make_pair(at, at),
+				[](const std::pair<Vector2, Vector2>& a, const std::pair<Vector2, Vector2>& b) { return IsLess(a.first, b.first); });
+
+			auto next = borders.size();
+			auto bestAngle = (std::numeric_limits<float>::max)();
+			for (auto it = range.first; it != range.second; ++it)
+			{
+				auto angle = backAngle - atan2f(it->second.y - at.y, it->second.x - at.x);
+				if (angle <= 0.f)
+					angle += 2.f * static_cast<float>(E_PI);
+				if (angle < bestAngle)
+				{
+					bestAngle = angle;
+					next = it - borders.begin();
+				}
+			}
+			if (next == borders.size())
+				break;
+			current = next;
+		}
+
+		//A shape that doesn't close is the result of rounding errors, leave it out
+		if (current == start && shape.size() >= 3)
+			walkableShapes.push_back(std::move(shape));
+	}
+
+	//5. Triangulate
+	std::vector<Triangle*> vpTriangles;
+	Polygon::TriangulateMonotone(walkableShapes, vpTriangles);
+	tile.triangles.reserve(vpTriangles.size());
+	for (auto t : vpTriangles)
+	{
+		tile.triangles.push_back(*t);
+		SAFE_DELETE(t);
+	}
+}
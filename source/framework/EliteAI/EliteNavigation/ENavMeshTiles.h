@@ -0,0 +1,45 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// ENavMeshTiles.h: Navigation mesh cut in tiles that are triangulated on their own.
+// When obstacles change only the tiles they overlap are triangulated again. Neighbouring tiles split their shared
+// border at exactly the same points, so their triangles line up and the line matrix of the mesh stitches them together.
+/*=============================================================================*/
+#pragma once
+
+#include "framework/EliteGeometry/EGeometry2DTypes.h"
+
+namespace Elite
+{
+	class NavMeshTiles final
+	{
+	public:
+		//A tile size of 0 puts the whole contour in one tile. Holes of the contour are treated as obstacles
+		NavMeshTiles(const Polygon& contour, float tileSize);
+
+		//Bins the obstacles in the tiles they overlap and triangulates the tiles where those changed.
+		//Obstacles can overlap each other, returns the amount of tiles that got triangulated again
+		int Update(const std::vector<Polygon>& obstacles);
+
+		std::vector<Triangle> GetTriangles() const;
+		int GetNrOfTiles() const { return static_cast<int>(m_Tiles.size()); }
+
+	private:
+		struct Tile
+		{
+			Vector2 min = {};
+			Vector2 max = {};
+			bool isBuilt = false;
+			std::vector<std::vector<Vector2>> obstacles; //Obstacles overlapping the tile when it was triangulated
+			std::vector<Triangle> triangles;
+		};
+
+		void BuildTile(Tile& tile) const;
+
+		std::vector<Vector2> m_Contour;
+		std::vector<std::vector<Vector2>> m_ContourHoles;
+		std::vector<Tile> m_Tiles;
+		int m_Columns = 0;
+		int m_Rows = 0;
+	};
+}
@@ -5,6 +5,7 @@
 // EGeometryTypes.cpp: Implementation of some of the Common 2D Geometry Types.
 /*=============================================================================*/
 #include "stdafx.h"
+#include <set>
 //#include "EGeometry.h"
 #include "EGeometry2DTypes.h"
 #include "EGeometry2DUtilities.h"
@@ -165,6 +166,26 @@ bool Elite::Polygon::OverlappingYAxis(const Polygon& poly) const
 
 std::vector<Elite::Triangle*> Elite::Polygon::GetAdjacentTriangles(const Triangle* t) const
 {
+#ifdef USE_TRIANGLE_METADATA
+	//Every line of a triangle is shared with at most one other triangle, look them up in the line matrix
+	if (!m_vpLineTriangles.empty())
+	{
+		std::vector<Triangle*> adjTriangles;
+		for (const int lineIndex : t->metaData.IndexLines)
+		{
+			if (lineIndex < 0 || lineIndex >= static_cast<int>(m_vpLineTriangles.size()))
+				continue;
+
+			for (auto ct : m_vpLineTriangles[lineIndex])
+			{
+				if (ct && ct != t)
+					adjTriangles.push_back(ct);
+			}
+		}
+		return adjTriangles;
+	}
+#endif
+
 	//For this triangle, go over all triangles and look if any of it's edges matches the edges of a triangle,
 	//in other words, two points overlap. If two points match, it's an adjacent triangle
 	std::vector<Triangle*> adjTriangles;
@@ -197,25 +218,17 @@ std::vector<Elite::Triangle*> Elite::Polygon::GetAdjacentTrianglesOnLine(const T
 
 #ifdef USE_TRIANGLE_METADATA
 	//Start by getting index of line in matrix
-	auto lRev = Line(l.p2, l.p1);
-	const auto it = std::find_if(m_vpLines.begin(), m_vpLines.end(), [&](const Line* rl)
-	{ return (*rl == l || *rl == lRev); });
-	if (it == m_vpLines.end())
+	const auto it = m_LineIndices.find(GetLineKey(l.p1, l.p2));
+	if (it == m_LineIndices.end())
 	{
 		std::cout << "WARNING: line not found!" << std::endl;
 		return adjTriangles;
 	}
-	const int lineIndex = it - m_vpLines.begin();
 
-	//Go over all the triangles and compare lines
-	for (auto ct : m_vpTriangles)
+	//The other triangle on that line
+	for (auto ct : m_vpLineTriangles[it->second])
 	{
-		if (t == ct) //If same triangle, ignore
-			continue;
-
-		if (ct->metaData.IndexLines[0] == lineIndex
-			|| ct->metaData.IndexLines[1] == lineIndex
-			|| ct->metaData.IndexLines[2] == lineIndex)
+		if (ct && ct != t)
 			adjTriangles.push_back(ct);
 	}
 #endif
@@ -225,26 +238,51 @@ std::vector<Elite::Triangle*> Elite::Polygon::GetAdjacentTrianglesOnLine(const T
 
 const Elite::Triangle* Elite::Polygon::GetTriangleFromPosition(const Vector2& position, bool onLineAllowed /*= false*/) const
 {
-	for (size_t i = 0; i < m_vpTriangles.size(); i++)
+	//No grid yet, test every triangle
+	if (m_vGridCellStarts.empty())
 	{
-		if (PointInTriangle(position, m_vpTriangles[i]->p1, m_vpTriangles[i]->p2, m_vpTriangles[i]->p3, onLineAllowed))
-			return m_vpTriangles[i];
+		for (size_t i = 0; i < m_vpTriangles.size(); i++)
+		{
+			if (PointInTriangle(position, m_vpTriangles[i]->p1, m_vpTriangles[i]->p2, m_vpTriangles[i]->p3, onLineAllowed))
+				return m_vpTriangles[i];
+		}
+		return nullptr;
+	}
+
+	//Only the triangles overlapping the cell of the position can contain it
+	const int cellIdx = GetGridCellIdx(position);
+	if (cellIdx == -1)
+		return nullptr;
+
+	for (int i = m_vGridCellStarts[cellIdx]; i < m_vGridCellStarts[cellIdx + 1]; ++i)
+	{
+		const Triangle* pTriangle = m_vpTriangles[m_vGridTriangles[i]];
+		if (PointInTriangle(position, pTriangle->p1, pTriangle->p2, pTriangle->p3, onLineAllowed))
+			return pTriangle;
 	}
 	return nullptr;
 }
 
+std::vector<const Elite::Triangle*> Elite::Polygon::GetTrianglesFromPositions(const std::vector<Vector2>& positions, bool onLineAllowed /*= false*/) const
+{
+	std::vector<const Triangle*> vpTriangles;
+	vpTriangles.reserve(positions.size());
+	for (const auto& position : positions)
+		vpTriangles.push_back(GetTriangleFromPosition(position, onLineAllowed));
+	return vpTriangles;
+}
+
 #ifdef USE_TRIANGLE_METADATA
 const std::vector<const Elite::Triangle*> Elite::Polygon::GetTrianglesFromLineIndex(unsigned int lineIndex) const
 {
 	std::vector<const Triangle*> vpFoundTriangles = {};
-	for (auto pT : m_vpTriangles)
+	if (lineIndex >= m_vpLineTriangles.size())
+		return vpFoundTriangles;
+
+	for (auto pT : m_vpLineTriangles[lineIndex])
 	{
-		if (pT->metaData.IndexLines[0] == lineIndex ||
-			pT->metaData.IndexLines[1] == lineIndex ||
-			pT->metaData.IndexLines[2] == lineIndex)
-		{
+		if (pT)
 			vpFoundTriangles.push_back(pT);
-		}
 	}
 	return vpFoundTriangles;
 }
@@ -256,88 +294,44 @@ const std::vector<const Elite::Triangle*> Elite::Polygon::GetTrianglesFromLineIn
 #pragma region TriangulationFunctions
 const std::vector<Elite::Triangle*>& Elite::Polygon::Triangulate()
 {
-	//Check winding
-	OrientateWithChildren(Winding::CCW);
+	//Triangle list - Clear first (if already containing triangles)
+	for (auto t : m_vpTriangles)
+		SAFE_DELETE(t);
+	m_vpTriangles.clear();
 
-	//TODO: CHECK FOR OVERLAPPING POLYGONS AND MERGE WHEN REQUIRED
-	for (auto child : m_vChildren)
-	{
-		//Check for overlap, if so merge, create new child and remove old ones!
-		//FILL IN FUNCTIONS!
-	}
+	if (m_TriangulationMethod == TriangulationMethod::MonotonePartition)
+		TriangulateMonotonePartition();
+	else
+		TriangulateEarClipping();
 
-	//Sort the children. Start by sorting from top to bottom (verices are what matters, not the "center" pos of the polygon!)
-	std::sort(m_vChildren.begin(), m_vChildren.end(),
-		[](const Polygon& p1, const Polygon& p2)
-	{ return p1.GetPosVertMaxYPos() > p2.GetPosVertMaxYPos(); });
+	//Flag as triangulated for later use
+	m_isTriangulated = true; 
 
-	//Copy children as backup after sort
-	const auto children = m_vChildren;
-	
-	//THEN, we check two elements, if the don't overlap horizontally you don't do anything, else you swap them based on right most object
-	for (auto i = 0; i < static_cast<int>(m_vChildren.size()) - 1; ++i)
-	{
-		if (m_vChildren[i].OverlappingYAxis(m_vChildren[i + 1]))
-		{
-			//Swap if i.y < i+1.y
-			if (m_vChildren[i].GetPosVertMaxXPos() < m_vChildren[i + 1].GetPosVertMaxXPos())
-			{
-				const auto temp = m_vChildren[i];
-				m_vChildren[i] = m_vChildren[i + 1];
-				m_vChildren[i + 1] = temp;
-			}
-		}
-	}
+#ifdef USE_TRIANGLE_METADATA
+	GenerateLineMatrix();
+#endif
+	GenerateTriangleGrid();
 
-	//First split polygon
-	while (m_vChildren.size() != 0)
-		Split();
+	return m_vpTriangles;
+}
 
-	//Triangle list - Clear first (if already containing triangles)
+const std::vector<Elite::Triangle*>& Elite::Polygon::SetTriangles(const std::vector<Triangle>& triangles)
+{
 	for (auto t : m_vpTriangles)
 		SAFE_DELETE(t);
 	m_vpTriangles.clear();
 
-	std::list<Vector2> copyPoints;
-	copyPoints.assign(m_vPoints.begin(), m_vPoints.end()); //Copy
+	m_vpTriangles.reserve(triangles.size());
+	for (const auto& t : triangles)
+		m_vpTriangles.push_back(new Triangle(t.p1, t.p2, t.p3));
 
-	//For each ear, remove ear and push verts, recheck earness (including convexness obviously :-))!
-	while (copyPoints.size() > 3)
-	{
-		list<Vector2>::const_iterator earListIt = copyPoints.end();
-		for (auto it = copyPoints.begin(); it != copyPoints.end(); ++it)
-		{
-			if (earListIt != copyPoints.end())
-				break;
-			if (IsConvexInPolygon(copyPoints, it) && IsEar(copyPoints, it))
-				earListIt = it;
-		}
-
-		//Push triangle
-		Vector2 current, prev, next;
-		GetTriangle(copyPoints, earListIt, current, prev, next);
-		Triangle* t = new Triangle(prev, current, next);
-		m_vpTriangles.push_back(t);
-
-		//Remove current from pointslist
-		const auto currentIt = std::find(copyPoints.begin(), copyPoints.end(), current);
-		copyPoints.erase(currentIt); //remove
-	}
-	//Add the remaining 3 vertices to the triangulated polygon
-	std::vector<Vector2> tempCopy;
-	for (const auto p : copyPoints)
-		tempCopy.push_back(p);
-	Triangle* lastTriangle = new Triangle(tempCopy[0], tempCopy[1], tempCopy[2]);
-	m_vpTriangles.push_back(lastTriangle);
-
-	//Flag as triangulated for later use
-	m_isTriangulated = true; 
+	m_isTriangulated = true;
 
 #ifdef USE_TRIANGLE_METADATA
 	GenerateLineMatrix();
 #endif
+	GenerateTriangleGrid();
 
-	m_vChildren = children;
 	return m_vpTriangles;
 }
 
@@ -390,6 +384,172 @@ void Elite::Polygon::ExpandShape(float amount)
 }
 #pragma endregion //TriangulationFunctions
 //----------------------------------------------------------
+#pragma region FileFunctions
+namespace
+{
+	struct PolygonFileGrid
+	{
+		Elite::Vector2 origin;
+		Elite::Vector2 cellSize;
+		int32_t columns;
+		int32_t rows;
+	};
+
+	const uint32_t PolygonPointsId = CompileTimeLiteralStringHash("PolygonPoints");
+	const uint32_t PolygonChildSizesId = CompileTimeLiteralStringHash("PolygonChildSizes");
+	const uint32_t PolygonChildPointsId = CompileTimeLiteralStringHash("PolygonChildPoints");
+	const uint32_t PolygonTrianglesId = CompileTimeLiteralStringHash("PolygonTriangles");
+	const uint32_t PolygonLinesId = CompileTimeLiteralStringHash("PolygonLines");
+	const uint32_t PolygonGridId = CompileTimeLiteralStringHash("PolygonGrid");
+	const uint32_t PolygonGridCellStartsId = CompileTimeLiteralStringHash("PolygonGridCellStarts");
+	const uint32_t PolygonGridTrianglesId = CompileTimeLiteralStringHash("PolygonGridTriangles");
+}
+
+void Elite::Polygon::Save(BinaryFileWriter& file) const
+{
+	file.AddSection(PolygonPointsId, std::vector<Vector2>(m_vPoints.begin(), m_vPoints.end()));
+
+	std::vector<uint32_t> childSizes;
+	std::vector<Vector2> childPoints;
+	for (const auto& child : m_vChildren)
+	{
+		childSizes.push_back(static_cast<uint32_t>(child.m_vPoints.size()));
+		childPoints.insert(childPoints.end(), child.m_vPoints.begin(), child.m_vPoints.end());
+	}
+	file.AddSection(PolygonChildSizesId, childSizes);
+	file.AddSection(PolygonChildPointsId, childPoints);
+
+	std::vector<Triangle> triangles;
+	triangles.reserve(m_vpTriangles.size());
+	for (const auto t : m_vpTriangles)
+		triangles.push_back(*t);
+	file.AddSection(PolygonTrianglesId, triangles);
+
+#ifdef USE_TRIANGLE_METADATA
+	std::vector<Line> lines;
+	lines.reserve(m_vpLines.size());
+	for (const auto l : m_vpLines)
+		lines.push_back(*l);
+	file.AddSection(PolygonLinesId, lines);
+#endif
+
+	const PolygonFileGrid grid{ m_GridOrigin, m_GridCellSize, m_GridColumns, m_GridRows };
+	file.AddSection(PolygonGridId, &grid, 1);
+	file.AddSection(PolygonGridCellStartsId, m_vGridCellStarts);
+	file.AddSection(PolygonGridTrianglesId, m_vGridTriangles);
+}
+
+bool Elite::Polygon::Load(const BinaryFileView& file)
+{
+	//Check everything first, the line and grid indices are used without checks later on
+	size_t nrOfPoints = 0, nrOfChildren = 0, nrOfChildPoints = 0, nrOfTriangles = 0, nrOfGrids = 0, nrOfCellStarts = 0, nrOfGridTriangles = 0;
+	const auto pPoints = file.GetSection<Vector2>(PolygonPointsId, nrOfPoints);
+	const auto pChildSizes = file.GetSection<uint32_t>(PolygonChildSizesId, nrOfChildren);
+	const auto pChildPoints = file.GetSection<Vector2>(PolygonChildPointsId, nrOfChildPoints);
+	const auto pTriangles = file.GetSection<Triangle>(PolygonTrianglesId, nrOfTriangles);
+	const auto pGrid = file.GetSection<PolygonFileGrid>(PolygonGridId, nrOfGrids);
+	const auto pCellStarts = file.GetSection<int>(PolygonGridCellStartsId, nrOfCellStarts);
+	const auto pGridTriangles = file.GetSection<int>(PolygonGridTrianglesId, nrOfGridTriangles);
+	if (!pPoints || !pChildSizes || !pChildPoints || !pTriangles || !pGrid || nrOfGrids != 1 || !pCellStarts || !pGridTriangles)
+		return false;
+
+	size_t totalChildPoints = 0;
+	for (size_t i = 0; i < nrOfChildren; ++i)
+		totalChildPoints += pChildSizes[i];
+	if (totalChildPoints != nrOfChildPoints)
+		return false;
+
+#ifdef USE_TRIANGLE_METADATA
+	size_t nrOfLines = 0;
+	const auto pLines = file.GetSection<Line>(PolygonLinesId, nrOfLines);
+	if (!pLines)
+		return false;
+	for (size_t i = 0; i < nrOfLines; ++i)
+	{
+		if (pLines[i].index != static_cast<int>(i))
+			return false;
+	}
+	for (size_t i = 0; i < nrOfTriangles; ++i)
+	{
+		for (const int lineIdx : pTriangles[i].metaData.IndexLines)
+		{
+			if (lineIdx < 0 || lineIdx >= static_cast<int>(nrOfLines))
+				return false;
+		}
+	}
+#endif
+
+	if (nrOfCellStarts > 0)
+	{
+		if (pGrid->columns <= 0 || pGrid->rows <= 0 || nrOfCellStarts != size_t(pGrid->columns) * size_t(pGrid->rows) + 1
+			|| pCellStarts[0] != 0 || pCellStarts[nrOfCellStarts - 1] != static_cast<int>(nrOfGridTriangles))
+			return false;
+		for (size_t i = 1; i < nrOfCellStarts; ++i)
+		{
+			if (pCellStarts[i] < pCellStarts[i - 1])
+				return false;
+		}
+		for (size_t i = 0; i < nrOfGridTriangles; ++i)
+		{
+			if (pGridTriangles[i] < 0 || pGridTriangles[i] >= static_cast<int>(nrOfTriangles))
+				return false;
+		}
+	}
+
+	//Shapes
+	m_vPoints.assign(pPoints, pPoints + nrOfPoints);
+	m_vChildren.clear();
+	for (size_t i = 0, first = 0; i < nrOfChildren; first += pChildSizes[i++])
+		m_vChildren.emplace_back(std::vector<Vector2>(pChildPoints + first, pChildPoints + first + pChildSizes[i]));
+
+	//Triangles
+	for (auto t : m_vpTriangles)
+		SAFE_DELETE(t);
+	m_vpTriangles.clear();
+	m_vpTriangles.reserve(nrOfTriangles);
+	for (size_t i = 0; i < nrOfTriangles; ++i)
+		m_vpTriangles.push_back(new Triangle(pTriangles[i]));
+	m_isTriangulated = nrOfTriangles > 0;
+
+#ifdef USE_TRIANGLE_METADATA
+	//Line matrix, only the lookups are filled in again
+	for (auto l : m_vpLines)
+		SAFE_DELETE(l);
+	m_vpLines.clear();
+	m_LineIndices.clear();
+	m_vpLines.reserve(nrOfLines);
+	m_LineIndices.reserve(nrOfLines);
+	for (size_t i = 0; i < nrOfLines; ++i)
+	{
+		m_vpLines.push_back(new Line(pLines[i]));
+		m_LineIndices.emplace(GetLineKey(pLines[i].p1, pLines[i].p2), static_cast<int>(i));
+	}
+
+	m_vpLineTriangles.assign(nrOfLines, { { nullptr, nullptr } });
+	for (auto t : m_vpTriangles)
+	{
+		for (const int lineIdx : t->metaData.IndexLines)
+		{
+			auto& lineTriangles = m_vpLineTriangles[lineIdx];
+			if (!lineTriangles[0])
+				lineTriangles[0] = t;
+			else if (!lineTriangles[1])
+				lineTriangles[1] = t;
+		}
+	}
+#endif
+
+	//Triangle grid
+	m_GridOrigin = pGrid->origin;
+	m_GridCellSize = pGrid->cellSize;
+	m_GridColumns = pGrid->columns;
+	m_GridRows = pGrid->rows;
+	m_vGridCellStarts.assign(pCellStarts, pCellStarts + nrOfCellStarts);
+	m_vGridTriangles.assign(pGridTriangles, pGridTriangles + nrOfGridTriangles);
+	return true;
+}
+#pragma endregion //FileFunctions
+//----------------------------------------------------------
 #pragma region PrivateGeneralFunctions
 void Elite::Polygon::GetTriangle(const list<Vector2>& l, const list<Vector2>::const_iterator p, Vector2& currentTip, Vector2& previous, Vector2& next) const
 {
@@ -439,48 +599,136 @@ bool Elite::Polygon::IsEar(const list<Vector2>& l, const list<Vector2>::const_it
 void Elite::Polygon::GenerateLineMatrix()
 {
 #ifdef USE_TRIANGLE_METADATA
+	//Start from scratch, the triangles could have been made again
+	for (auto l : m_vpLines)
+		SAFE_DELETE(l);
+	m_vpLines.clear();
+	m_vpLineTriangles.clear();
+	m_LineIndices.clear();
+	m_LineIndices.reserve(m_vpTriangles.size() * 2);
+
 	//Go over all the triangles
 	for (auto t : m_vpTriangles)
 	{
 		//Go over all the lines of the triangle, search if they are already in the matrix
-		//If not add them and store it's index in the triangles meta data
-		const Line l1{ t->p1, t->p2 };
-		const Line l1rev{ t->p2, t->p1 };
-		const Line l2{ t->p2, t->p3 };
-		const Line l2rev{ t->p3, t->p2 };
-		const Line l3{ t->p3, t->p1 };
-		const Line l3rev{ t->p1, t->p3 };
-		for (auto i = 0; i < static_cast<int>(m_vpLines.size()); ++i)
+		//If not add them, store it's index in the triangles meta data and the triangle on the line
+		const std::array<Vector2, 3> points{ { t->p1, t->p2, t->p3 } };
+		for (auto i = 0; i < 3; ++i)
 		{
-			const auto l = m_vpLines[i];
-			if (*l == l1 || *l == l1rev)
-				t->metaData.IndexLines[0] = i;
-			if (*l == l2 || *l == l2rev)
-				t->metaData.IndexLines[1] = i;
-			if (*l == l3 || *l == l3rev)
-				t->metaData.IndexLines[2] = i;
-		}
-		//Not found, add to matrix
-		if (t->metaData.IndexLines[0] == -1)
-		{
-			const int index = m_vpLines.size();
-			m_vpLines.push_back(new Line(t->p1, t->p2, index));
-			t->metaData.IndexLines[0] = index;
-		}
-		if (t->metaData.IndexLines[1] == -1)
-		{
-			const int index = m_vpLines.size();
-			m_vpLines.push_back(new Line(t->p2, t->p3, index));
-			t->metaData.IndexLines[1] = index;
+			const auto& p1 = points[i];
+			const auto& p2 = points[(i + 1) % 3];
+			const auto result = m_LineIndices.emplace(GetLineKey(p1, p2), static_cast<int>(m_vpLines.size()));
+			const int index = result.first->second;
+
+			//Not found, add to matrix
+			if (result.second)
+			{
+				m_vpLines.push_back(new Line(p1, p2, index));
+				m_vpLineTriangles.push_back({ { nullptr, nullptr } });
+			}
+			t->metaData.IndexLines[i] = index;
+
+			//A valid triangulation never has more than two triangles on a line
+			auto& lineTriangles = m_vpLineTriangles[index];
+			if (!lineTriangles[0])
+				lineTriangles[0] = t;
+			else if (!lineTriangles[1])
+				lineTriangles[1] = t;
 		}
-		if (t->metaData.IndexLines[2] == -1)
+	}
+#endif
+}
+
+#ifdef USE_TRIANGLE_METADATA
+size_t Elite::Polygon::LineKeyHasher::operator()(const LineKey& k) const
+{
+	const std::hash<int64_t> hasher{};
+	size_t seed = hasher(k.x1);
+	for (const int64_t c : { k.y1, k.x2, k.y2 })
+		seed ^= hasher(c) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+	return seed;
+}
+
+Elite::Polygon::LineKey Elite::Polygon::GetLineKey(const Vector2& p1, const Vector2& p2)
+{
+	//Ordered on the snapped points, so the order can't differ from the comparison
+	const int64_t x1 = llroundf(p1.x / LineKeyPrecision);
+	const int64_t y1 = llroundf(p1.y / LineKeyPrecision);
+	const int64_t x2 = llroundf(p2.x / LineKeyPrecision);
+	const int64_t y2 = llroundf(p2.y / LineKeyPrecision);
+	if (x1 < x2 || (x1 == x2 && y1 <= y2))
+		return LineKey{ x1, y1, x2, y2 };
+	return LineKey{ x2, y2, x1, y1 };
+}
+#endif
+
+void Elite::Polygon::GenerateTriangleGrid()
+{
+	m_vGridCellStarts.clear();
+	m_vGridTriangles.clear();
+	if (m_vpTriangles.empty())
+		return;
+
+	//Bounds of all triangles
+	Vector2 minPos = { (std::numeric_limits<float>::max)(), (std::numeric_limits<float>::max)() };
+	Vector2 maxPos = { std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest() };
+	for (const auto t : m_vpTriangles)
+	{
+		for (const auto& p : { t->p1, t->p2, t->p3 })
 		{
-			const int index = m_vpLines.size();
-			m_vpLines.push_back(new Line(t->p3, t->p1, index));
-			t->metaData.IndexLines[2] = index;
+			minPos.x = (std::min)(minPos.x, p.x);
+			minPos.y = (std::min)(minPos.y, p.y);
+			maxPos.x = (std::max)(maxPos.x, p.x);
+			maxPos.y = (std::max)(maxPos.y, p.y);
 		}
 	}
-#endif
+
+	//About one cell per triangle, as square as the bounds allow
+	const Vector2 size = { (std::max)(maxPos.x - minPos.x, FLT_EPSILON), (std::max)(maxPos.y - minPos.y, FLT_EPSILON) };
+	const float cellSize = sqrtf(size.x * size.y / m_vpTriangles.size());
+	m_GridColumns = Clamp(static_cast<int>(ceilf(size.x / cellSize)), 1, 1024);
+	m_GridRows = Clamp(static_cast<int>(ceilf(size.y / cellSize)), 1, 1024);
+	m_GridOrigin = minPos;
+	m_GridCellSize = { size.x / m_GridColumns, size.y / m_GridRows };
+
+	//Two passes over the bounding boxes: count the triangles per cell, then fill them in
+	auto forEachOverlappedCell = [this](const Triangle* t, const std::function<void(int)>& function)
+	{
+		const Vector2 tMin = { (std::min)({ t->p1.x, t->p2.x, t->p3.x }), (std::min)({ t->p1.y, t->p2.y, t->p3.y }) };
+		const Vector2 tMax = { (std::max)({ t->p1.x, t->p2.x, t->p3.x }), (std::max)({ t->p1.y, t->p2.y, t->p3.y }) };
+		const int minCol = Clamp(static_cast<int>((tMin.x - m_GridOrigin.x) / m_GridCellSize.x), 0, m_GridColumns - 1);
+		const int maxCol = Clamp(static_cast<int>((tMax.x - m_GridOrigin.x) / m_GridCellSize.x), 0, m_GridColumns - 1);
+		const int minRow = Clamp(static_cast<int>((tMin.y - m_GridOrigin.y) / m_GridCellSize.y), 0, m_GridRows - 1);
+		const int maxRow = Clamp(static_cast<int>((tMax.y - m_GridOrigin.y) / m_GridCellSize.y), 0, m_GridRows - 1);
+		for (int r = minRow; r <= maxRow; ++r)
+			for (int c = minCol; c <= maxCol; ++c)
+				function(r * m_GridColumns + c);
+	};
+
+	m_vGridCellStarts.assign(m_GridColumns * m_GridRows + 1, 0);
+	for (const auto t : m_vpTriangles)
+		forEachOverlappedCell(t, [this](int cellIdx) { ++m_vGridCellStarts[cellIdx + 1]; });
+
+	for (size_t i = 1; i < m_vGridCellStarts.size(); ++i)
+		m_vGridCellStarts[i] += m_vGridCellStarts[i - 1];
+
+	//Triangles go in per cell in the order of m_vpTriangles, so lookups find the same triangle as a linear search
+	std::vector<int> fillPositions(m_vGridCellStarts.begin(), m_vGridCellStarts.end() - 1);
+	m_vGridTriangles.resize(m_vGridCellStarts.back());
+	for (int i = 0; i < static_cast<int>(m_vpTriangles.size()); ++i)
+		forEachOverlappedCell(m_vpTriangles[i], [this, i, &fillPositions](int cellIdx) { m_vGridTriangles[fillPositions[cellIdx]++] = i; });
+}
+
+int Elite::Polygon::GetGridCellIdx(const Vector2& position) const
+{
+	//Positions on the border still count as inside the grid
+	const float col = (position.x - m_GridOrigin.x) / m_GridCellSize.x;
+	const float row = (position.y - m_GridOrigin.y) / m_GridCellSize.y;
+	const float margin = 0.01f;
+	if (col < -margin || row < -margin || col > m_GridColumns + margin || row > m_GridRows + margin)
+		return -1;
+
+	return Clamp(static_cast<int>(row), 0, m_GridRows - 1) * m_GridColumns + Clamp(static_cast<int>(col), 0, m_GridColumns - 1);
 }
 #pragma endregion //PrivateGeneralFunctions
 //----------------------------------------------------------
@@ -644,6 +892,396 @@ void Elite::Polygon::Split()
 	m_vChildren.clear();
 	m_vChildren = newChildren;
 }
+
+void Elite::Polygon::TriangulateEarClipping()
+{
+	//Check winding
+	OrientateWithChildren(Winding::CCW);
+
+	//TODO: CHECK FOR OVERLAPPING POLYGONS AND MERGE WHEN REQUIRED
+	for (auto child : m_vChildren)
+	{
+		//Check for overlap, if so merge, create new child and remove old ones!
+		//FILL IN FUNCTIONS!
+	}
+
+	//Sort the children. Start by sorting from top to bottom (verices are what matters, not the "center" pos of the polygon!)
+	std::sort(m_vChildren.begin(), m_vChildren.end(),
+		[](const Polygon& p1, const Polygon& p2)
+	{ return p1.GetPosVertMaxYPos() > p2.GetPosVertMaxYPos(); });
+
+	//Copy children as backup after sort
+	const auto children = m_vChildren;
+	
+	//THEN, we check two elements, if the don't overlap horizontally you don't do anything, else you swap them based on right most object
+	for (auto i = 0; i < static_cast<int>(m_vChildren.size()) - 1; ++i)
+	{
+		if (m_vChildren[i].OverlappingYAxis(m_vChildren[i + 1]))
+		{
+			//Swap if i.y < i+1.y
+			if (m_vChildren[i].GetPosVertMaxXPos() < m_vChildren[i + 1].GetPosVertMaxXPos())
+			{
+				const auto temp = m_vChildren[i];
+				m_vChildren[i] = m_vChildren[i + 1];
+				m_vChildren[i + 1] = temp;
+			}
+		}
+	}
+
+	//First split polygon
+	while (m_vChildren.size() != 0)
+		Split();
+
+	std::list<Vector2> copyPoints;
+	copyPoints.assign(m_vPoints.begin(), m_vPoints.end()); //Copy
+
+	//For each ear, remove ear and push verts, recheck earness (including convexness obviously :-))!
+	while (copyPoints.size() > 3)
+	{
+		list<Vector2>::const_iterator earListIt = copyPoints.end();
+		for (auto it = copyPoints.begin(); it != copyPoints.end(); ++it)
+		{
+			if (earListIt != copyPoints.end())
+				break;
+			if (IsConvexInPolygon(copyPoints, it) && IsEar(copyPoints, it))
+				earListIt = it;
+		}
+
+		//Push triangle
+		Vector2 current, prev, next;
+		GetTriangle(copyPoints, earListIt, current, prev, next);
+		Triangle* t = new Triangle(prev, current, next);
+		m_vpTriangles.push_back(t);
+
+		//Remove current from pointslist
+		const auto currentIt = std::find(copyPoints.begin(), copyPoints.end(), current);
+		copyPoints.erase(currentIt); //remove
+	}
+	//Add the remaining 3 vertices to the triangulated polygon
+	std::vector<Vector2> tempCopy;
+	for (const auto p : copyPoints)
+		tempCopy.push_back(p);
+	Triangle* lastTriangle = new Triangle(tempCopy[0], tempCopy[1], tempCopy[2]);
+	m_vpTriangles.push_back(lastTriangle);
+
+	m_vChildren = children;
+}
+
+void Elite::Polygon::TriangulateMonotonePartition()
+{
+	//The outer shape goes CCW and the holes CW, with these windings the inside is always on the left side of an edge
+	std::vector<std::vector<Vector2>> shapes;
+	auto addShape = [&shapes](const std::list<Vector2>& shape, bool isCCW)
+	{
+		if (shape.size() < 3)
+			return;
+
+		shapes.emplace_back(shape.begin(), shape.end());
+		auto& points = shapes.back();
+		auto area = 0.f;
+		for (size_t i = 0; i < points.size(); ++i)
+			area += Cross(points[i], points[(i + 1) % points.size()]);
+		if ((area > 0.f) != isCCW)
+			std::reverse(points.begin(), points.end());
+	};
+	addShape(m_vPoints, true);
+	for (const auto& child : m_vChildren)
+		addShape(child.GetPoints(), false);
+
+	TriangulateMonotone(shapes, m_vpTriangles);
+}
+
+void Elite::Polygon::TriangulateMonotone(const std::vector<std::vector<Vector2>>& shapes, std::vector<Triangle*>& triangles)
+{
+	//Put all shapes in one list of vertices with links to their neighbours
+	std::vector<Vector2> points;
+	std::vector<int> nextIdx;
+	std::vector<int> prevIdx;
+	for (const auto& shape : shapes)
+	{
+		const int count = static_cast<int>(shape.size());
+		if (count < 3)
+			continue;
+
+		const int first = static_cast<int>(points.size());
+		points.insert(points.end(), shape.begin(), shape.end());
+		for (auto i = 0; i < count; ++i)
+		{
+			nextIdx.push_back(first + (i + 1) % count);
+			prevIdx.push_back(first + (i + count - 1) % count);
+		}
+	}
+
+	const int nrOfPoints = static_cast<int>(points.size());
+	if (nrOfPoints < 3)
+		return;
+
+	//The sweep line goes from top to bottom, points at the same height are handled from left to right
+	auto isAbove = [&points](int a, int b)
+	{ return points[a].y > points[b].y || (points[a].y == points[b].y && points[a].x < points[b].x); };
+
+	std::vector<int> sweepOrder(nrOfPoints);
+	for (auto i = 0; i < nrOfPoints; ++i)
+		sweepOrder[i] = i;
+	std::sort(sweepOrder.begin(), sweepOrder.end(), isAbove);
+
+	enum class VertexType { Start, End, Split, Merge, Regular };
+	std::vector<VertexType> types(nrOfPoints);
+	for (auto i = 0; i < nrOfPoints; ++i)
+	{
+		const bool isPrevAbove = isAbove(prevIdx[i], i);
+		const bool isNextAbove = isAbove(nextIdx[i], i);
+		const bool isConvex = Cross(points[i] - points[prevIdx[i]], points[nextIdx[i]] - points[i]) > 0.f;
+		if (!isPrevAbove && !isNextAbove)
+			types[i] = isConvex ? VertexType::Start : VertexType::Split;
+		else if (isPrevAbove && isNextAbove)
+			types[i] = isConvex ? VertexType::End : VertexType::Merge;
+		else
+			types[i] = VertexType::Regular;
+	}
+
+	//1. Sweep: the edges that have the inside on their right are kept in the status, an edge is known by the index of its top point.
+	//Every edge keeps a helper, the lowest vertex above the sweep line it can see to its right. Split vertices get a diagonal up
+	//to the helper of the edge to their left, merge vertices get one down to the next vertex that replaces them as helper.
+	//The status is ordered on the x of the edges at the sweep line. Edges don't cross, so that order stays the same while
+	//the line moves down and finding or removing an edge is O(log n)
+	float sweepY = 0.f;
+	auto getEdgeX = [&points, &nextIdx](int edge, float y)
+	{
+		const auto& p1 = points[edge];
+		const auto& p2 = points[nextIdx[edge]];
+		return (p1.y == p2.y) ? (std::max)(p1.x, p2.x) : p1.x + (y - p1.y) * (p2.x - p1.x) / (p2.y - p1.y);
+	};
+	struct EdgeOrder final
+	{
+		using is_transparent = void;
+		const decltype(getEdgeX)& getX;
+		const float& y;
+
+		bool operator()(int a, int b) const
+		{
+			const float xA = getX(a, y);
+			const float xB = getX(b, y);
+			return xA < xB || (xA == xB && a < b);
+		}
+		bool operator()(int edge, float x) const { return getX(edge, y) < x; }
+		bool operator()(float x, int edge) const { return x < getX(edge, y); }
+	};
+	using Status = std::set<int, EdgeOrder>;
+	Status status{ EdgeOrder{ getEdgeX, sweepY } };
+	std::vector<Status::iterator> statusIts(nrOfPoints, status.end());
+	std::vector<int> helpers(nrOfPoints, -1);
+	std::vector<std::vector<int>> neighbours(nrOfPoints);
+	for (auto i = 0; i < nrOfPoints; ++i)
+		neighbours[i] = { prevIdx[i], nextIdx[i] };
+
+	auto addDiagonal = [&neighbours, &points](int a, int b)
+	{
+		//Shapes that touch share points, a diagonal between those wouldn't cut anything
+		if (a == b || points[a] == points[b] || std::find(neighbours[a].begin(), neighbours[a].end(), b) != neighbours[a].end())
+			return;
+		neighbours[a].push_back(b);
+		neighbours[b].push_back(a);
+	};
+	auto connectToMergeHelper = [&](int v, int edge)
+	{
+		if (helpers[edge] != -1 && types[helpers[edge]] == VertexType::Merge)
+			addDiagonal(v, helpers[edge]);
+	};
+	auto removeEdge = [&status, &statusIts](int edge)
+	{
+		if (statusIts[edge] == status.end())
+			return;
+		status.erase(statusIts[edge]);
+		statusIts[edge] = status.end();
+	};
+	auto findEdgeLeftOf = [&](int v)
+	{
+		//The last edge that isn't right of the vertex
+		auto it = status.upper_bound(points[v].x);
+		return (it == status.begin()) ? -1 : *--it;
+	};
+	auto insertEdge = [&](int v)
+	{
+		statusIts[v] = status.insert(v).first;
+		helpers[v] = v;
+	};
+
+	for (const int v : sweepOrder)
+	{
+		sweepY = points[v].y;
+		const int prevEdge = prevIdx[v];
+		switch (types[v])
+		{
+		case VertexType::Start:
+			insertEdge(v);
+			break;
+		case VertexType::End:
+			connectToMergeHelper(v, prevEdge);
+			removeEdge(prevEdge);
+			break;
+		case VertexType::Split:
+		{
+			const int leftEdge = findEdgeLeftOf(v);
+			if (leftEdge != -1)
+			{
+				addDiagonal(v, helpers[leftEdge]);
+				helpers[leftEdge] = v;
+			}
+			insertEdge(v);
+			break;
+		}
+		case VertexType::Merge:
+		{
+			connectToMergeHelper(v, prevEdge);
+			removeEdge(prevEdge);
+			const int leftEdge = findEdgeLeftOf(v);
+			if (leftEdge != -1)
+			{
+				connectToMergeHelper(v, leftEdge);
+				helpers[leftEdge] = v;
+			}
+			break;
+		}
+		case VertexType::Regular:
+			//The boundary goes down here, so the inside is on the right of the vertex
+			if (isAbove(prevEdge, v))
+			{
+				connectToMergeHelper(v, prevEdge);
+				removeEdge(prevEdge);
+				insertEdge(v);
+			}
+			else
+			{
+				const int leftEdge = findEdgeLeftOf(v);
+				if (leftEdge != -1)
+				{
+					connectToMergeHelper(v, leftEdge);
+					helpers[leftEdge] = v;
+				}
+			}
+			break;
+		}
+	}
+
+	//2. Walk the pieces the diagonals cut out. Sort the neighbours of every vertex around it, coming from a neighbour
+	//the next vertex of the piece is the first neighbour clockwise from it, which keeps the inside on the left
+	for (auto i = 0; i < nrOfPoints; ++i)
+	{
+		std::sort(neighbours[i].begin(), neighbours[i].end(), [&points, i](int a, int b)
+		{
+			return atan2f(points[a].y - points[i].y, points[a].x - points[i].x)
+				< atan2f(points[b].y - points[i].y, points[b].x - points[i].x);
+		});
+	}
+
+	std::vector<std::vector<bool>> isWalked(nrOfPoints);
+	for (auto i = 0; i < nrOfPoints; ++i)
+		isWalked[i].assign(neighbours[i].size(), false);
+
+	std::vector<Vector2> piece;
+	for (auto i = 0; i < nrOfPoints; ++i)
+	{
+		for (const int neighbour : neighbours[i])
+		{
+			//Boundary edges only have the inside on their left in the direction of the shape
+			if (neighbour == prevIdx[i] && neighbour != nextIdx[i])
+				continue;
+
+			piece.clear();
+			int from = i;
+			int to = neighbour;
+			while (true)
+			{
+				const auto& fromNeighbours = neighbours[from];
+				const int walkedIdx = static_cast<int>(std::find(fromNeighbours.begin(), fromNeighbours.end(), to) - fromNeighbours.begin());
+				if (isWalked[from][walkedIdx])
+					break;
+				isWalked[from][walkedIdx] = true;
+				piece.push_back(points[from]);
+
+				const auto& toNeighbours = neighbours[to];
+				const int count = static_cast<int>(toNeighbours.size());
+				const int backIdx = static_cast<int>(std::find(toNeighbours.begin(), toNeighbours.end(), from) - toNeighbours.begin());
+				from = to;
+				to = toNeighbours[(backIdx + count - 1) % count];
+			}
+
+			TriangulateMonotonePiece(piece, triangles);
+		}
+	}
+}
+
+void Elite::Polygon::TriangulateMonotonePiece(const std::vector<Vector2>& piece, std::vector<Triangle*>& triangles)
+{
+	//Piece is CCW and y-monotone. Triangles are stored CCW, just like the ones from ear clipping
+	auto addTriangle = [&triangles](const Vector2& p1, const Vector2& p2, const Vector2& p3)
+	{
+		if (Cross(p2 - p1, p3 - p1) < 0.f)
+			triangles.push_back(new Triangle(p1, p3, p2));
+		else
+			triangles.push_back(new Triangle(p1, p2, p3));
+	};
+
+	const int count = static_cast<int>(piece.size());
+	if (count < 3)
+		return;
+	if (count == 3)
+	{
+		addTriangle(piece[0], piece[1], piece[2]);
+		return;
+	}
+
+	auto isAbove = [&piece](int a, int b)
+	{ return piece[a].y > piece[b].y || (piece[a].y == piece[b].y && piece[a].x < piece[b].x); };
+
+	std::vector<int> sweepOrder(count);
+	for (auto i = 0; i < count; ++i)
+		sweepOrder[i] = i;
+	std::sort(sweepOrder.begin(), sweepOrder.end(), isAbove);
+
+	//Going CCW from the top the left chain goes down to the bottom, the rest is the right chain
+	std::vector<bool> isLeftChain(count, false);
+	for (int i = (sweepOrder.front() + 1) % count; i != sweepOrder.back(); i = (i + 1) % count)
+		isLeftChain[i] = true;
+
+	//The stack holds the vertices that still need triangles, they form a reflex chain
+	std::vector<int> stack{ sweepOrder[0], sweepOrder[1] };
+	for (auto j = 2; j < count - 1; ++j)
+	{
+		const int v = sweepOrder[j];
+		if (isLeftChain[v] != isLeftChain[stack.back()])
+		{
+			//Other chain, v sees the whole stack
+			for (size_t k = 0; k + 1 < stack.size(); ++k)
+				addTriangle(piece[v], piece[stack[k]], piece[stack[k + 1]]);
+			stack = { sweepOrder[j - 1], v };
+		}
+		else
+		{
+			//Same chain, cut off triangles for as long as the diagonal stays inside
+			int last = stack.back();
+			stack.pop_back();
+			while (!stack.empty())
+			{
+				const auto cross = Cross(piece[stack.back()] - piece[v], piece[last] - piece[v]);
+				if (isLeftChain[v] ? cross <= 0.f : cross >= 0.f)
+					break;
+
+				addTriangle(piece[v], piece[stack.back()], piece[last]);
+				last = stack.back();
+				stack.pop_back();
+			}
+			stack.push_back(last);
+			stack.push_back(v);
+		}
+	}
+
+	//The bottom vertex sees everything that is left
+	const int bottom = sweepOrder.back();
+	for (size_t k = 0; k + 1 < stack.size(); ++k)
+		addTriangle(piece[bottom], piece[stack[k]], piece[stack[k + 1]]);
+}
 #pragma endregion //PrivateTriangulationFunctions
 //----------------------------------------------------------
 #pragma endregion //Polygon
@@ -8,7 +8,9 @@
 #define	ELITE_GEOMETRY_TYPES
 
 #include "EGeometry2DUtilities.h"
+#include "framework/EliteHelpers/EBinaryFile.h"
 #include <array>
+#include <unordered_map>
 
 
 namespace Elite 
@@ -78,6 +80,12 @@ namespace Elite
 #pragma endregion //Triangle
 
 #pragma region Polygon
+	enum class TriangulationMethod
+	{
+		EarClipping, //Cuts the holes open and clips ears one by one, O(n^2) or worse
+		MonotonePartition //Sweeps the polygon with its holes into y-monotone pieces and triangulates those, O(n log n)
+	};
+
 	class Polygon final
 	{
 	public:
@@ -117,6 +125,7 @@ namespace Elite
 		std::vector<Triangle*> GetAdjacentTrianglesOnLine(const Triangle* t, const Line& l) const;
 
 		const Triangle* GetTriangleFromPosition(const Vector2& position, bool onLineAllowed = false) const;
+		std::vector<const Triangle*> GetTrianglesFromPositions(const std::vector<Vector2>& positions, bool onLineAllowed = false) const;
 #ifdef USE_TRIANGLE_METADATA
 		const std::vector<const Triangle*> GetTrianglesFromLineIndex(unsigned int lineIndex) const;
 #endif
@@ -125,9 +134,20 @@ namespace Elite
 
 		//Triangulation functions
 		const std::vector<Triangle*>& Triangulate();
+		void SetTriangulationMethod(TriangulationMethod method) { m_TriangulationMethod = method; }
+		TriangulationMethod GetTriangulationMethod() const { return m_TriangulationMethod; }
+		//Uses triangles made somewhere else (e.g. per tile of a navigation mesh) and builds the same metadata as Triangulate
+		const std::vector<Triangle*>& SetTriangles(const std::vector<Triangle>& triangles);
+		//Triangulates shapes that have the inside on their left side (outer shapes CCW, holes CW), shapes can't cross each other
+		static void TriangulateMonotone(const std::vector<std::vector<Vector2>>& shapes, std::vector<Triangle*>& triangles);
 		void OrientateWithChildren(Winding winding);
 		void ExpandShape(float amount);
 
+		//File functions, the triangles come with their line matrix and grid so loading only copies them.
+		//Load returns false and leaves the polygon as it was when the file holds no (valid) polygon
+		void Save(BinaryFileWriter& file) const;
+		bool Load(const BinaryFileView& file);
+
 		//=== Operators ===
 		bool operator ==(const Polygon& b) const
 		{ return this->m_vChildren == b.m_vChildren && this->m_vPoints == b.m_vPoints; }
@@ -139,6 +159,42 @@ namespace Elite
 		std::vector<Triangle*> m_vpTriangles; //Triangles create for this polygon, used for rendering
 		std::vector<Line*> m_vpLines; //Lines constructing this polygon!
 		bool m_isTriangulated = false;
+		TriangulationMethod m_TriangulationMethod = TriangulationMethod::EarClipping;
+
+		//Uniform grid over the triangles, made after triangulating to find the triangle of a position fast
+		//Cell i lists the triangles whose bounding box overlaps it in m_vGridTriangles[m_vGridCellStarts[i]..m_vGridCellStarts[i + 1]]
+		Vector2 m_GridOrigin = {};
+		Vector2 m_GridCellSize = {};
+		int m_GridColumns = 0;
+		int m_GridRows = 0;
+		std::vector<int> m_vGridCellStarts;
+		std::vector<int> m_vGridTriangles;
+
+#ifdef USE_TRIANGLE_METADATA
+		//Line matrix lookups, filled in by GenerateLineMatrix
+		//A line is keyed on its two points in a fixed order, so both directions of an edge map to the same line.
+		//The points are snapped to a grid of LineKeyPrecision first, so float noise doesn't split a shared line and
+		//the key can be compared and hashed exactly
+		static constexpr float LineKeyPrecision = 1e-4f;
+		struct LineKey final
+		{
+			int64_t x1 = 0;
+			int64_t y1 = 0;
+			int64_t x2 = 0;
+			int64_t y2 = 0;
+
+			bool operator==(const LineKey& k) const
+			{ return (k.x1 == x1 && k.y1 == y1 && k.x2 == x2 && k.y2 == y2); }
+		};
+		struct LineKeyHasher final
+		{
+			size_t operator()(const LineKey& k) const;
+		};
+		static LineKey GetLineKey(const Vector2& p1, const Vector2& p2);
+
+		std::unordered_map<LineKey, int, LineKeyHasher> m_LineIndices; //Line -> index in m_vpLines
+		std::vector<std::array<Triangle*, 2>> m_vpLineTriangles; //Line index -> the (at most two) triangles sharing it
+#endif
 
 		//=== Functions ===
 		//Private General Functions
@@ -146,10 +202,15 @@ namespace Elite
 		bool IsConvexInPolygon(const list<Vector2>& l, const list<Vector2>::const_iterator p) const;
 		bool IsEar(const list<Vector2>& l, const list<Vector2>::const_iterator p) const;
 		void GenerateLineMatrix();
+		void GenerateTriangleGrid();
+		int GetGridCellIdx(const Vector2& position) const;
 
 		//Private Triangulation Functions
 		void FindMutualVisibleVertices(const Polygon& outer, const Polygon& inner, Vector2& pOuter, Vector2& pInner);
 		void Split();
+		void TriangulateEarClipping();
+		void TriangulateMonotonePartition();
+		static void TriangulateMonotonePiece(const std::vector<Vector2>& piece, std::vector<Triangle*>& triangles);
 	};
 #pragma endregion //Polygon
 
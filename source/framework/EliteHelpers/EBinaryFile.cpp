@@ -0,0 +1,128 @@
+#include "stdafx.h"
+#include "EBinaryFile.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
+using namespace Elite;
+
+namespace
+{
+	uint64_t AlignOffset(uint64_t offset)
+	{ return (offset + BinarySectionAlignment - 1) / BinarySectionAlignment * BinarySectionAlignment; }
+}
+
+std::vector<char> Elite::BinaryFileWriter::GetBuffer() const
+{
+	//Header, table of sections and then the data of every section
+	auto offset = AlignOffset(sizeof(BinaryFileHeader) + sizeof(BinarySectionHeader) * m_Sections.size());
+	std::vector<BinarySectionHeader> sectionHeaders;
+	sectionHeaders.reserve(m_Sections.size());
+	for (const auto& section : m_Sections)
+	{
+		sectionHeaders.push_back({ section.id, section.elementSize, offset, section.count });
+		offset = AlignOffset(offset + section.data.size());
+	}
+
+	std::vector<char> buffer(size_t(offset), 0);
+	const BinaryFileHeader header{ BinaryFileMagic, BinaryFileVersion, uint32_t(m_Sections.size()), 0 };
+	std::memcpy(buffer.data(), &header, sizeof(header));
+	if (!sectionHeaders.empty())
+		std::memcpy(buffer.data() + sizeof(header), sectionHeaders.data(), sizeof(BinarySectionHeader) * sectionHeaders.size());
+	for (size_t i = 0; i < m_Sections.size(); ++i)
+	{
+		if (!m_Sections[i].data.empty())
+			std::memcpy(buffer.data() + sectionHeaders[i].offset, m_Sections[i].data.data(), m_Sections[i].data.size());
+	}
+	return buffer;
+}
+
+bool Elite::BinaryFileWriter::Save(const std::string& path) const
+{
+	const auto buffer = GetBuffer();
+	std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	file.write(buffer.data(), buffer.size());
+	return file.good();
+}
+
+void Elite::BinaryFileView::SetData(const char* pData, size_t size)
+{
+	m_pData = nullptr;
+	m_pHeader = nullptr;
+	m_pSections = nullptr;
+	if (!pData || size < sizeof(BinaryFileHeader) || reinterpret_cast<uintptr_t>(pData) % BinarySectionAlignment != 0)
+		return;
+
+	const auto pHeader = reinterpret_cast<const BinaryFileHeader*>(pData);
+	if (pHeader->magic != BinaryFileMagic || pHeader->version != BinaryFileVersion
+		|| pHeader->nrOfSections > (size - sizeof(BinaryFileHeader)) / sizeof(BinarySectionHeader))
+		return;
+
+	//Every section has to lie inside the file and be aligned, after this the sections can be trusted
+	const auto pSections = reinterpret_cast<const BinarySectionHeader*>(pData + sizeof(BinaryFileHeader));
+	for (uint32_t i = 0; i < pHeader->nrOfSections; ++i)
+	{
+		const auto& section = pSections[i];
+		if (section.offset % BinarySectionAlignment != 0 || section.offset > size || section.elementSize == 0
+			|| section.count > (size - section.offset) / section.elementSize)
+			return;
+	}
+
+	m_pData = pData;
+	m_pHeader = pHeader;
+	m_pSections = pSections;
+}
+
+Elite::BinaryFile::BinaryFile(const std::string& path)
+{
+#ifdef _WIN32
+	const auto hFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return;
+	m_pFileHandle = hFile;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(hFile, &size) || size.QuadPart == 0)
+		return;
+
+	m_pMappingHandle = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_pMappingHandle)
+		return;
+
+	m_pMappedView = MapViewOfFile(m_pMappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (m_pMappedView)
+		SetData(static_cast<const char*>(m_pMappedView), size_t(size.QuadPart));
+#else
+	std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+	if (!file.is_open())
+		return;
+
+	const auto size = size_t(file.tellg());
+	m_Buffer.resize((size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+	file.seekg(0);
+	if (file.read(reinterpret_cast<char*>(m_Buffer.data()), size))
+		SetData(reinterpret_cast<const char*>(m_Buffer.data()), size);
+#endif
+}
+
+Elite::BinaryFile::~BinaryFile()
+{
+#ifdef _WIN32
+	if (m_pMappedView)
+		UnmapViewOfFile(m_pMappedView);
+	if (m_pMappingHandle)
+		CloseHandle(m_pMappingHandle);
+	if (m_pFileHandle)
+		CloseHandle(m_pFileHandle);
+#endif
+}
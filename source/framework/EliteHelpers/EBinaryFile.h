@@ -0,0 +1,152 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EBinaryFile.h: versioned binary file made of sections, every section is an array of plain values.
+// The data of a section is stored exactly like it is in memory and aligned, so a file that is mapped into memory
+// (or read in one go) can be used in place without parsing. Several processes can map the same file.
+// Files are written in the byte order of the machine, which is little endian on every platform we support.
+/*=============================================================================*/
+#ifndef ELITE_BINARY_FILE
+#define ELITE_BINARY_FILE
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Elite
+{
+	//Section ids are hashes of a name, e.g. CompileTimeLiteralStringHash("GridTerrain")
+	struct BinaryFileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t nrOfSections;
+		uint32_t reserved;
+	};
+
+	struct BinarySectionHeader
+	{
+		uint32_t id;
+		uint32_t elementSize;
+		uint64_t offset; //From the start of the file
+		uint64_t count;
+	};
+
+	const uint32_t BinaryFileMagic = 0x46424C45; //"ELBF"
+	const uint32_t BinaryFileVersion = 1;
+	const uint64_t BinarySectionAlignment = 8;
+
+	class BinaryFileWriter final
+	{
+	public:
+		template<class T>
+		void AddSection(uint32_t id, const T* pData, size_t count);
+		template<class T>
+		void AddSection(uint32_t id, const std::vector<T>& data) { AddSection(id, data.data(), data.size()); }
+
+		std::vector<char> GetBuffer() const;
+		bool Save(const std::string& path) const;
+
+	private:
+		struct Section
+		{
+			uint32_t id;
+			uint32_t elementSize;
+			uint64_t count;
+			std::vector<char> data;
+		};
+
+		std::vector<Section> m_Sections;
+	};
+
+	//Reads the sections of a file that is already in memory, nothing gets copied.
+	//The memory has to stay alive and be aligned to at least BinarySectionAlignment
+	class BinaryFileView
+	{
+	public:
+		BinaryFileView() = default;
+		BinaryFileView(const char* pData, size_t size) { SetData(pData, size); }
+		virtual ~BinaryFileView() = default;
+
+		//False when the data is no file of this version or a section lies outside of it
+		bool IsValid() const { return m_pHeader != nullptr; }
+
+		//Returns nullptr when the section doesn't exist or holds a different type
+		template<class T>
+		const T* GetSection(uint32_t id, size_t& count) const;
+		template<class T>
+		bool CopySection(uint32_t id, std::vector<T>& data) const;
+
+	protected:
+		void SetData(const char* pData, size_t size);
+
+	private:
+		const char* m_pData = nullptr;
+		const BinaryFileHeader* m_pHeader = nullptr;
+		const BinarySectionHeader* m_pSections = nullptr;
+	};
+
+	//Maps a file into memory for as long as it lives, where that isn't supported the file is read in one go
+	class BinaryFile final : public BinaryFileView
+	{
+	public:
+		explicit BinaryFile(const std::string& path);
+		~BinaryFile();
+
+		BinaryFile(const BinaryFile&) = delete;
+		BinaryFile& operator=(const BinaryFile&) = delete;
+
+	private:
+		void* m_pFileHandle = nullptr;
+		void* m_pMappingHandle = nullptr;
+		const void* m_pMappedView = nullptr;
+		std::vector<uint64_t> m_Buffer; //Aligned storage when the file is read instead of mapped
+	};
+
+	template<class T>
+	void BinaryFileWriter::AddSection(uint32_t id, const T* pData, size_t count)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "only plain values can be used in place");
+		static_assert(alignof(T) <= BinarySectionAlignment, "sections aren't aligned enough for this type");
+
+		Section section{ id, uint32_t(sizeof(T)), uint64_t(count), std::vector<char>(sizeof(T) * count) };
+		if (count > 0)
+			std::memcpy(section.data.data(), pData, sizeof(T) * count);
+		m_Sections.push_back(std::move(section));
+	}
+
+	template<class T>
+	const T* BinaryFileView::GetSection(uint32_t id, size_t& count) const
+	{
+		count = 0;
+		if (!IsValid())
+			return nullptr;
+
+		for (uint32_t i = 0; i < m_pHeader->nrOfSections; ++i)
+		{
+			const auto& section = m_pSections[i];
+			if (section.id != id)
+				continue;
+			if (section.elementSize != sizeof(T))
+				return nullptr;
+
+			count = size_t(section.count);
+			return reinterpret_cast<const T*>(m_pData + section.offset);
+		}
+		return nullptr;
+	}
+
+	template<class T>
+	bool BinaryFileView::CopySection(uint32_t id, std::vector<T>& data) const
+	{
+		size_t count = 0;
+		const T* pSection = GetSection<T>(id, count);
+		if (!pSection)
+			return false;
+
+		data.assign(pSection, pSection + count);
+		return true;
+	}
+}
+#endif
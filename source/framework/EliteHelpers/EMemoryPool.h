@@ -2,79 +2,144 @@
 // Copyright 2017-2018 Elite Engine
 // Authors: Matthieu Delaere
 /*=============================================================================*/
-// EMemoryPool.h: class that implements a memory pool. Pool is expandable, but NOT pointer to other pool SAFE.
-// TODO: make EMemoryPool thread safe - fix expandability pointer to pool problem!
+// EMemoryPool.h: class that implements a memory pool. Pool grows by chaining blocks of the same size, units never move.
+// Getting and releasing units is lock-free and can happen from any thread, only growing the pool takes a lock.
+// Units are returned to an intrusive free list and reused, so pointers stay valid until that unit is released.
+// Use EObjectArena instead for objects that a single owner creates and frees on one thread, like the nodes of a graph:
+// it has no atomics or bookkeeping per unit, grows its blocks geometrically and frees everything at once. This pool pays
+// for being shared between threads and for knowing its live units (GetAllActiveUnits, Flush).
 /*=============================================================================*/
 #ifndef ELITE_MEMORYPOOL
 #define ELITE_MEMORYPOOL
 #include <stdlib.h>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
 #include "EMemoryPoolHelpers.h"
 
 namespace Elite
 {
-	template<class T, class = std::enable_if<std::is_base_of<IPoolable<T>, T>::value>>
+	template<class T>
 	class EMemoryPool final
 	{
 	public:
 		//--- Constructors & Destructors ---
 		EMemoryPool() = default;
+		explicit EMemoryPool(unsigned int unitsPerBlock, bool isExpandable = true)
+		{ InitializePool(unitsPerBlock, isExpandable); }
 		~EMemoryPool()
 		{ DestroyPool(); }
 
+		EMemoryPool(const EMemoryPool&) = delete;
+		EMemoryPool& operator=(const EMemoryPool&) = delete;
+
 		//--- Public Functions ---
-		//Initialize should be called before using MemoryPool. 
+		//Initialize should be called before using MemoryPool.
 		//This prevents memory pool allocation for local objects that are used as parameters for copying Data in pool
+		//Every block holds amount units, an expandable pool chains extra blocks when it runs out
 		void InitializePool(unsigned int amount, bool isExpandable = false)
 		{
 			if (m_IsInitialized)
 				return;
 
-			m_TotalAmountUnits = amount;
+			m_UnitsPerBlock = amount;
 			m_IsExpandable = isExpandable;
 			m_IsInitialized = true;
 
-			//Calculate size of pool
-			auto sizePerUnit = sizeof(T);
-			auto totalSizePool = amount * sizePerUnit;
-
-			//Allocate pool and prepare datamembers for usage
-			m_pMemoryBlock = static_cast<T*>(malloc(totalSizePool));
-			m_pFreeHead = m_pMemoryBlock;
+			AddBlock();
 		}
 
+		//Not thread-safe, no other thread can use the pool while it gets destroyed
 		void DestroyPool()
 		{
-			//Safety, pool has to be initialized first and it should have data!
-			if (!m_IsInitialized || !m_pMemoryBlock)
+			//Safety, pool has to be initialized first!
+			if (!m_IsInitialized)
 				return;
-			//Flush pool to call all Destroy() functions
+			//Flush pool to destroy all units that are still in use
 			Flush();
-			//Deallocate pool
-			free(m_pMemoryBlock);
-			m_pMemoryBlock = nullptr;
+			//Deallocate all blocks
+			const unsigned int nrOfBlocks = m_NrOfBlocks.load();
+			for (unsigned int i = 0; i < nrOfBlocks; ++i)
+			{
+				free(m_pBlocks[i].load());
+				m_pBlocks[i].store(nullptr);
+			}
+			m_NrOfBlocks.store(0);
+			m_FreeHead.store(PackFreeListHead(invalid_pool_index, 0));
+			m_IsInitialized = false;
 		}
 
-		T* GetAvailableUnit()
+		//Constructs a unit with the given arguments, returns nullptr when the pool is full and can't expand
+		template<class... Args>
+		T* GetAvailableUnit(Args&&... args)
+		{
+			void* pMemory = GetUnitMemory();
+			if (!pMemory)
+				return nullptr;
+
+			static_cast<Slot*>(pMemory)->isConstructedByPool = true;
+			return new (pMemory) T(std::forward<Args>(args)...);
+		}
+
+		void ReleaseUnit(T* pUnit)
+		{
+			if (!pUnit)
+				return;
+
+			pUnit->~T();
+			ReleaseUnitMemory(pUnit);
+		}
+
+		//Raw memory for a single unit, for class specific operator new/delete
+		//Flush and DestroyPool leave the objects living in these units alone
+		void* GetUnitMemory()
 		{
 			//Safety, pool has to be initialized first!
 			if (!m_IsInitialized)
 				return nullptr;
-			//If we currently have reached the limit, check if we are allowed to resize
-			if (m_CurrentAmountInUse == m_TotalAmountUnits && !m_IsExpandable)
-				return nullptr; //If not, return a nullptr
-			else if (m_CurrentAmountInUse == m_TotalAmountUnits && m_IsExpandable)
-				ExpandPool(); //Else expand the pool
-
-			//Return available head and adjust variables
-			auto pAvailableUnit = m_pFreeHead;
-			*pAvailableUnit = {}; //Set data of unit to NULL if you want to
-			++m_pFreeHead;
-			++m_CurrentAmountInUse;
-			return pAvailableUnit;
+
+			unsigned long long head = m_FreeHead.load(std::memory_order_acquire);
+			while (true)
+			{
+				const unsigned int idx = GetFreeListIndex(head);
+				if (idx == invalid_pool_index)
+				{
+					//If we currently have reached the limit, check if we are allowed to grow
+					if (!ExpandPool())
+						return nullptr;
+
+					head = m_FreeHead.load(std::memory_order_acquire);
+					continue;
+				}
+
+				//The tag changes on every pop, so a unit that got popped and pushed back in between makes this fail
+				Slot* pSlot = GetSlot(idx);
+				const unsigned int nextIdx = pSlot->nextIdx.load(std::memory_order_relaxed);
+				if (m_FreeHead.compare_exchange_weak(head, PackFreeListHead(nextIdx, GetFreeListTag(head) + 1),
+					std::memory_order_acquire, std::memory_order_acquire))
+				{
+					pSlot->isInUse.store(true, std::memory_order_relaxed);
+					pSlot->isConstructedByPool = false;
+					++m_CurrentAmountInUse;
+					return pSlot->data;
+				}
+			}
 		}
 
-		//Return pointer to first used unit and the amount of units in use.
-		//This can be used to iterate over all the active unites.
+		void ReleaseUnitMemory(void* pMemory)
+		{
+			if (!pMemory)
+				return;
+
+			Slot* pSlot = static_cast<Slot*>(pMemory);
+			pSlot->isInUse.store(false, std::memory_order_relaxed);
+			--m_CurrentAmountInUse;
+			PushFreeList(pSlot->index, pSlot);
+		}
+
+		//Return pointers to all the active units. Not thread-safe, units can't be added or released meanwhile
 		std::vector<T*> GetAllActiveUnits() const
 		{
 			//Local variables
@@ -82,66 +147,117 @@ namespace Elite
 			//Safety, pool has to be initialized first!
 			if (!m_IsInitialized)
 				return container;
-			//Reserve space and copy all pointers in container and return.
-			//TODO: optimize this!
-			container.reserve(m_CurrentAmountInUse);
-			auto tempUnit = m_pMemoryBlock;
-			for (unsigned int i = 0; i < m_CurrentAmountInUse; ++i)
+
+			container.reserve(m_CurrentAmountInUse.load());
+			const unsigned int nrOfBlocks = m_NrOfBlocks.load();
+			for (unsigned int i = 0; i < nrOfBlocks; ++i)
 			{
-				container.push_back(tempUnit);
-				++tempUnit;
+				Slot* pBlock = m_pBlocks[i].load();
+				for (unsigned int j = 0; j < m_UnitsPerBlock; ++j)
+				{
+					if (pBlock[j].isInUse.load(std::memory_order_relaxed))
+						container.push_back(reinterpret_cast<T*>(pBlock[j].data));
+				}
 			}
 			return container;
 		}
 
+		unsigned int GetAmountInUse() const { return m_CurrentAmountInUse.load(); }
+
+		//Destroys all units made by GetAvailableUnit and puts them back on the free list. Not thread-safe
 		void Flush()
 		{
-			//Safety, pool has to be initialized first and it should have data!
-			if (!m_IsInitialized || !m_pMemoryBlock)
+			//Safety, pool has to be initialized first!
+			if (!m_IsInitialized)
 				return;
 
-			//Keep memoryblock, do not reset units, but reset the variables
-			T* pCurrentObj = m_pMemoryBlock;
-			for (unsigned int i = 0; i < m_CurrentAmountInUse; ++i)
+			for (T* pUnit : GetAllActiveUnits())
 			{
-				//Every T inherits from IPoolable, which should provide implementation Destroy()!
-				pCurrentObj->Destroy();
-				++pCurrentObj;
+				if (reinterpret_cast<Slot*>(pUnit)->isConstructedByPool)
+					ReleaseUnit(pUnit);
 			}
-			m_pFreeHead = m_pMemoryBlock;
-			m_CurrentAmountInUse = 0;
 		}
 
 	private:
+		//--- Private Types ---
+		//A unit in the pool, the link to the next free unit sits next to the data instead of inside it,
+		//a thread that lost the race for a unit can still read its link while the winner constructs the unit
+		struct Slot
+		{
+			alignas(T) unsigned char data[sizeof(T)];
+			std::atomic<unsigned int> nextIdx;
+			unsigned int index;
+			std::atomic<bool> isInUse;
+			bool isConstructedByPool;
+		};
+
 		//--- Private Functions ---
-		void ExpandPool()
+		Slot* GetSlot(unsigned int idx) const
+		{ return m_pBlocks[idx / m_UnitsPerBlock].load(std::memory_order_acquire) + idx % m_UnitsPerBlock; }
+
+		//Links a chain of free units in front of the free list, pLast is the end of the chain that starts at firstIdx
+		void PushFreeList(unsigned int firstIdx, Slot* pLast)
 		{
-			//Safety, pool has to be initialized first and it should have data!
-			if (!m_IsInitialized || !m_pMemoryBlock)
-				return;
+			unsigned long long head = m_FreeHead.load(std::memory_order_relaxed);
+			do
+			{
+				pLast->nextIdx.store(GetFreeListIndex(head), std::memory_order_relaxed);
+			} while (!m_FreeHead.compare_exchange_weak(head, PackFreeListHead(firstIdx, GetFreeListTag(head) + 1),
+				std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		bool ExpandPool()
+		{
+			std::lock_guard<std::mutex> lock{ m_ExpandMutex };
+
+			//Another thread might have grown the pool or released units while we were waiting
+			if (GetFreeListIndex(m_FreeHead.load(std::memory_order_acquire)) != invalid_pool_index)
+				return true;
+			if (!m_IsExpandable)
+				return false;
+
+			return AddBlock();
+		}
+
+		bool AddBlock()
+		{
+			const unsigned int blockIdx = m_NrOfBlocks.load();
+			if (m_UnitsPerBlock == 0 || blockIdx == MAX_BLOCKS)
+				return false;
 
-			//Allocate new block of double the size
-			auto sizePerUnit = sizeof(T);
-			auto newSizePool = (m_TotalAmountUnits * 2) * sizePerUnit;
-			auto pNewMemoryBlock = static_cast<T*>(malloc(newSizePool));
-			//Copy all data from old block to new block
-			auto oldSizePool = m_TotalAmountUnits * sizePerUnit;
-			memcpy(pNewMemoryBlock, m_pMemoryBlock, oldSizePool);
-			//Free old memory block
-			free(m_pMemoryBlock);
-			//Set new variables
-			m_pMemoryBlock = pNewMemoryBlock;
-			m_pFreeHead = m_pMemoryBlock + m_TotalAmountUnits; //Set to end of previous block, starting at the beginning of new segment
-			m_TotalAmountUnits *= 2;
+			//Chain all units of the new block, blocks are only ever added so their addresses stay valid
+			Slot* pBlock = static_cast<Slot*>(malloc(m_UnitsPerBlock * sizeof(Slot)));
+			if (!pBlock)
+				return false;
+
+			const unsigned int firstIdx = blockIdx * m_UnitsPerBlock;
+			for (unsigned int i = 0; i < m_UnitsPerBlock; ++i)
+			{
+				Slot* pSlot = new (pBlock + i) Slot;
+				pSlot->index = firstIdx + i;
+				pSlot->nextIdx.store(firstIdx + i + 1, std::memory_order_relaxed);
+				pSlot->isInUse.store(false, std::memory_order_relaxed);
+				pSlot->isConstructedByPool = false;
+			}
+
+			m_pBlocks[blockIdx].store(pBlock, std::memory_order_release);
+			m_NrOfBlocks.store(blockIdx + 1);
+
+			PushFreeList(firstIdx, pBlock + m_UnitsPerBlock - 1);
+			return true;
 		}
 
 		//--- Datamembers ---
-		T* m_pMemoryBlock = nullptr;
-		T* m_pFreeHead = nullptr;
-		unsigned int m_TotalAmountUnits = 0;
-		unsigned int m_CurrentAmountInUse = 0;
+		static const unsigned int MAX_BLOCKS = 1024;
+
+		std::atomic<Slot*> m_pBlocks[MAX_BLOCKS] = {};
+		std::atomic<unsigned int> m_NrOfBlocks{ 0 };
+		std::atomic<unsigned long long> m_FreeHead{ PackFreeListHead(invalid_pool_index, 0) };
+		std::atomic<unsigned int> m_CurrentAmountInUse{ 0 };
+		std::mutex m_ExpandMutex;
+		unsigned int m_UnitsPerBlock = 0;
 		bool m_IsExpandable = false;
 		bool m_IsInitialized = false;
 	};
 }
-#endif
\ No newline at end of file
+#endif
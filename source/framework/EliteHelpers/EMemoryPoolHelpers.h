@@ -8,18 +8,15 @@
 #define ELITE_MEMORYPOOL_HELPERS
 namespace Elite
 {
-	//Each item that can be stored in memorypool should inherit from this baseclass
-	template<typename poolableType>
-	class IPoolable
-	{
-	public:
-		//Every object that is poolable should also contain an empty default constructor that
-		//initializes everything to default values (NULL, nullptr, etc.)
+	//The head of a lock-free free list packs the index of the first free unit together with a tag.
+	//Every change bumps the tag, so a compare exchange fails when the same unit got popped and pushed back meanwhile.
+	const unsigned int invalid_pool_index = 0xFFFFFFFF;
 
-		//No virtual, but no implementation, so you cannot use this as an instance.
-		//Every Poolable object has to provide implementation of these functions!
-		void Initialize();
-		void Destroy();
-	};
+	inline unsigned long long PackFreeListHead(unsigned int index, unsigned int tag)
+	{ return (static_cast<unsigned long long>(tag) << 32) | index; }
+	inline unsigned int GetFreeListIndex(unsigned long long head)
+	{ return static_cast<unsigned int>(head & 0xFFFFFFFF); }
+	inline unsigned int GetFreeListTag(unsigned long long head)
+	{ return static_cast<unsigned int>(head >> 32); }
 }
 #endif
\ No newline at end of file
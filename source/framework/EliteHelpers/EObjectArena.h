@@ -0,0 +1,126 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EObjectArena.h: typed arena that hands out objects from a few big blocks instead of one allocation per object.
+// Blocks never move, so pointers to objects stay valid. Destroyed objects are reused.
+// Single-threaded and without any bookkeeping per object, use EMemoryPool for objects that are shared between threads.
+/*=============================================================================*/
+#ifndef ELITE_OBJECT_ARENA
+#define ELITE_OBJECT_ARENA
+#include <vector>
+#include <new>
+#include <utility>
+
+namespace Elite
+{
+	template<class T>
+	class EObjectArena final
+	{
+	public:
+		//--- Constructors & Destructors ---
+		explicit EObjectArena(unsigned int blockSize = 256)
+			: m_BlockSize(blockSize)
+		{}
+		~EObjectArena()
+		{ Release(); }
+
+		EObjectArena(const EObjectArena&) = delete;
+		EObjectArena& operator=(const EObjectArena&) = delete;
+
+		//--- Public Functions ---
+		//Makes sure the next amount of new objects end up next to each other in a single block
+		void Reserve(unsigned int amount)
+		{
+			if (GetFreeInLastBlock() < amount)
+				AllocateBlock(amount);
+		}
+
+		template<class... Args>
+		T* Create(Args&&... args)
+		{
+			Slot* pSlot = m_pFreeHead;
+			if (pSlot)
+			{
+				m_pFreeHead = pSlot->pNext;
+			}
+			else
+			{
+				//Blocks grow along with the arena, so the amount of allocations stays logarithmic
+				if (GetFreeInLastBlock() == 0)
+					AllocateBlock(m_Blocks.empty() ? m_BlockSize : m_Blocks.back().size * 2);
+
+				pSlot = m_Blocks.back().pSlots + m_UsedInLastBlock;
+				++m_UsedInLastBlock;
+			}
+
+			return new (pSlot->data) T(std::forward<Args>(args)...);
+		}
+
+		void Destroy(T* pObject)
+		{
+			if (!pObject)
+				return;
+
+			pObject->~T();
+			Slot* pSlot = reinterpret_cast<Slot*>(pObject);
+			pSlot->pNext = m_pFreeHead;
+			m_pFreeHead = pSlot;
+		}
+
+		//Frees all blocks at once without calling any destructor,
+		//destroy the objects first unless they are trivially destructible
+		void Release()
+		{
+			for (const Block& block : m_Blocks)
+				::operator delete(block.pSlots);
+
+			m_Blocks.clear();
+			m_pFreeHead = nullptr;
+			m_UsedInLastBlock = 0;
+		}
+
+		bool Owns(const T* pObject) const
+		{
+			const Slot* pSlot = reinterpret_cast<const Slot*>(pObject);
+			for (const Block& block : m_Blocks)
+			{
+				if (pSlot >= block.pSlots && pSlot < block.pSlots + block.size)
+					return true;
+			}
+
+			return false;
+		}
+
+	private:
+		//--- Private Types ---
+		//A free slot stores the next free slot where the object would be
+		union Slot
+		{
+			Slot* pNext;
+			alignas(T) unsigned char data[sizeof(T)];
+		};
+
+		struct Block
+		{
+			Slot* pSlots;
+			unsigned int size;
+		};
+
+		//--- Private Functions ---
+		unsigned int GetFreeInLastBlock() const
+		{ return m_Blocks.empty() ? 0 : m_Blocks.back().size - m_UsedInLastBlock; }
+
+		void AllocateBlock(unsigned int size)
+		{
+			m_Blocks.push_back(Block{ static_cast<Slot*>(::operator new(size * sizeof(Slot))), size });
+			m_UsedInLastBlock = 0;
+		}
+
+		//--- Datamembers ---
+		std::vector<Block> m_Blocks;
+		Slot* m_pFreeHead = nullptr;
+		unsigned int m_UsedInLastBlock = 0;
+		unsigned int m_BlockSize;
+	};
+}
+#endif
@@ -0,0 +1,225 @@
+#include "stdafx.h"
+#include "EParallel.h"
+
+using namespace Elite;
+
+namespace
+{
+	//The pool the current thread works for and the queue it owns there
+	thread_local const TaskPool* t_pWorkerPool = nullptr;
+	thread_local size_t t_QueueIdx = 0;
+}
+
+Elite::TaskPool::TaskPool(unsigned nrOfWorkers)
+{
+	for (unsigned i = 0; i <= nrOfWorkers; ++i)
+		m_Queues.push_back(std::make_unique<TaskQueue>());
+
+	//Every queue exists before the first worker can try to steal from it
+	for (unsigned i = 0; i < nrOfWorkers; ++i)
+		m_Workers.emplace_back(&TaskPool::WorkerLoop, this, size_t(i + 1));
+}
+
+Elite::TaskPool::~TaskPool()
+{
+	{
+		std::lock_guard<std::mutex> lock{ m_SleepMutex };
+		m_IsStopping = true;
+	}
+	m_WakeUp.notify_all();
+
+	for (auto& worker : m_Workers)
+		worker.join();
+}
+
+TaskPool& Elite::TaskPool::GetDefault()
+{
+	return JOBSYSTEM->GetTaskPool();
+}
+
+void Elite::TaskPool::Submit(Task task)
+{
+	{
+		TaskQueue& queue = *m_Queues[GetOwnQueueIdx()];
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		queue.tasks.push_back(std::move(task));
+	}
+
+	//Taking the lock makes sure a worker that is about to sleep sees the new task first
+	bool hasSleepingWaiters = false;
+	{
+		std::lock_guard<std::mutex> lock{ m_SleepMutex };
+		++m_NrOfQueuedTasks;
+		hasSleepingWaiters = m_NrOfSleepingWaiters > 0;
+	}
+	m_WakeUp.notify_one();
+
+	//A waiting worker can be the only one left to run it
+	if (hasSleepingWaiters)
+		m_WaiterWakeUp.notify_all();
+}
+
+bool Elite::TaskPool::RunPendingTask()
+{
+	Task task{};
+	if (!PopTask(task))
+		return false;
+
+	task();
+	return true;
+}
+
+void Elite::TaskPool::WaitUntil(const std::function<bool()>& isDone)
+{
+	while (!isDone())
+	{
+		if (RunPendingTask())
+			continue;
+
+		std::unique_lock<std::mutex> lock{ m_SleepMutex };
+		++m_NrOfSleepingWaiters;
+		m_WaiterWakeUp.wait(lock, [this, &isDone]() { return m_NrOfQueuedTasks > 0 || isDone(); });
+		--m_NrOfSleepingWaiters;
+	}
+}
+
+void Elite::TaskPool::NotifyWaiters()
+{
+	//Same as in Submit, a waiter that is about to sleep either sees the change or gets woken up
+	{
+		std::lock_guard<std::mutex> lock{ m_SleepMutex };
+		if (m_NrOfSleepingWaiters == 0)
+			return;
+	}
+	m_WaiterWakeUp.notify_all();
+}
+
+size_t Elite::TaskPool::GetOwnQueueIdx() const
+{
+	return t_pWorkerPool == this ? t_QueueIdx : 0;
+}
+
+bool Elite::TaskPool::PopTask(Task& task)
+{
+	if (m_NrOfQueuedTasks <= 0)
+		return false;
+
+	//Newest task of the own queue first, its data is most likely still in the cache
+	const size_t ownIdx = GetOwnQueueIdx();
+	{
+		TaskQueue& queue = *m_Queues[ownIdx];
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (!queue.tasks.empty())
+		{
+			task = std::move(queue.tasks.back());
+			queue.tasks.pop_back();
+			--m_NrOfQueuedTasks;
+			return true;
+		}
+	}
+
+	//Then steal the oldest task of another queue, those tend to be the biggest
+	for (size_t offset = 1; offset < m_Queues.size(); ++offset)
+	{
+		TaskQueue& queue = *m_Queues[(ownIdx + offset) % m_Queues.size()];
+		std::lock_guard<std::mutex> lock{ queue.mutex };
+		if (!queue.tasks.empty())
+		{
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			--m_NrOfQueuedTasks;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void Elite::TaskPool::WorkerLoop(size_t queueIdx)
+{
+	t_pWorkerPool = this;
+	t_QueueIdx = queueIdx;
+
+	while (true)
+	{
+		if (RunPendingTask())
+			continue;
+
+		std::unique_lock<std::mutex> lock{ m_SleepMutex };
+		m_WakeUp.wait(lock, [this]() { return m_IsStopping || m_NrOfQueuedTasks > 0; });
+		if (m_IsStopping)
+			return;
+	}
+}
+
+void Elite::ParallelFor(
+	int begin,
+	int end,
+	int grainSize,
+	const std::function<void(int first, int last)>& body,
+	const ProgressCallback& progress,
+	TaskPool& pool)
+{
+	if (end <= begin)
+		return;
+
+	grainSize = std::max(grainSize, 1);
+	const int nrOfChunks = (end - begin + grainSize - 1) / grainSize;
+
+	std::atomic<int> nextChunk{ 0 };
+	std::atomic<int> nrOfFinishedChunks{ 0 };
+	std::atomic<int> nrOfFinishedHelpers{ 0 };
+
+	auto runChunk = [&](int chunk)
+	{
+		const int first = begin + chunk * grainSize;
+		body(first, std::min(first + grainSize, end));
+		++nrOfFinishedChunks;
+
+		//The waiting thread reports the progress
+		if (progress)
+			pool.NotifyWaiters();
+	};
+
+	//The helpers use the locals of this call, so it can only return once all of them are done
+	const int nrOfHelpers = std::min(int(pool.GetConcurrency()) - 1, nrOfChunks - 1);
+	for (int i = 0; i < nrOfHelpers; ++i)
+	{
+		//Chunks are handed out one at a time, so the threads that are free take over from the ones that got a slow chunk
+		pool.Submit([&, pPool = &pool]()
+		{
+			for (int chunk = nextChunk++; chunk < nrOfChunks; chunk = nextChunk++)
+				runChunk(chunk);
+			++nrOfFinishedHelpers;
+
+			//The locals can be gone from here on, only the pool is still there
+			pPool->NotifyWaiters();
+		});
+	}
+
+	int nrOfReportedChunks = -1;
+	auto reportProgress = [&]()
+	{
+		const int nrOfChunksDone = nrOfFinishedChunks;
+		if (progress && nrOfChunksDone != nrOfReportedChunks)
+		{
+			progress(float(nrOfChunksDone) / nrOfChunks);
+			nrOfReportedChunks = nrOfChunksDone;
+		}
+	};
+
+	for (int chunk = nextChunk++; chunk < nrOfChunks; chunk = nextChunk++)
+	{
+		runChunk(chunk);
+		reportProgress();
+	}
+
+	//Other tasks can be waiting behind our helpers (a nested ParallelFor for instance), run those instead of idling
+	while (nrOfFinishedHelpers < nrOfHelpers)
+	{
+		pool.WaitUntil([&]()
+		{ return nrOfFinishedHelpers == nrOfHelpers || (progress && nrOfFinishedChunks != nrOfReportedChunks); });
+		reportProgress();
+	}
+	reportProgress();
+}
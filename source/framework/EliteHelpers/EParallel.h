@@ -0,0 +1,89 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EParallel.h: work-stealing pool of threads and a parallel-for on top of it, for preprocessing passes that split
+// over rows, directions or sources. Every thread owns a deque: it takes its own tasks from the back and steals from
+// the front of the others when it runs dry. Threads that aren't part of the pool hand in their tasks through a
+// shared deque and help out while they wait.
+/*=============================================================================*/
+#ifndef ELITE_PARALLEL
+#define ELITE_PARALLEL
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Elite
+{
+	//Called on the thread that started the work, with the finished fraction going from 0 to 1
+	using ProgressCallback = std::function<void(float)>;
+
+	class TaskPool final
+	{
+	public:
+		using Task = std::function<void()>;
+
+		//One thread less than the hardware has, the thread that waits for the work does its share as well
+		explicit TaskPool(unsigned nrOfWorkers = std::max(std::thread::hardware_concurrency(), 1u) - 1);
+		~TaskPool();
+
+		TaskPool(const TaskPool&) = delete;
+		TaskPool& operator=(const TaskPool&) = delete;
+
+		//Pool of the job system, shared by the framework
+		static TaskPool& GetDefault();
+
+		//Threads that can work at the same time, the workers plus the one waiting
+		unsigned GetConcurrency() const { return unsigned(m_Workers.size()) + 1; }
+
+		void Submit(Task task);
+
+		//Runs one queued task on the calling thread, returns false when there was none
+		bool RunPendingTask();
+
+		//Runs queued tasks on the calling thread until isDone returns true, sleeps while there is nothing to run.
+		//Whatever makes isDone true has to call NotifyWaiters afterwards, so a sleeping waiter checks it again
+		void WaitUntil(const std::function<bool()>& isDone);
+		void NotifyWaiters();
+
+	private:
+		struct TaskQueue
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		//Queue 0 is shared by the threads outside of the pool, worker i owns queue i + 1
+		std::vector<std::unique_ptr<TaskQueue>> m_Queues;
+		std::vector<std::thread> m_Workers;
+
+		std::atomic<int> m_NrOfQueuedTasks{ 0 };
+		std::atomic<bool> m_IsStopping{ false };
+		std::mutex m_SleepMutex;
+		std::condition_variable m_WakeUp;
+		std::condition_variable m_WaiterWakeUp; //Waiters sleep apart from the workers, finishing work doesn't wake the workers
+		int m_NrOfSleepingWaiters = 0; //Guarded by m_SleepMutex
+
+		size_t GetOwnQueueIdx() const;
+		bool PopTask(Task& task);
+		void WorkerLoop(size_t queueIdx);
+	};
+
+	//Calls body(first, last) for every chunk of grainSize items out of [begin, end), spread over the pool.
+	//The chunks only depend on grainSize and not on the amount of threads, so a body that only writes
+	//to the items it gets produces the same result on every machine.
+	//Returns when all chunks are done, the calling thread works along in the meantime
+	void ParallelFor(
+		int begin,
+		int end,
+		int grainSize,
+		const std::function<void(int first, int last)>& body,
+		const ProgressCallback& progress = nullptr,
+		TaskPool& pool = TaskPool::GetDefault());
+}
+#endif
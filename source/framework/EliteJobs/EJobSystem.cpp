@@ -0,0 +1,76 @@
+#include "stdafx.h"
+#include "EJobSystem.h"
+
+using namespace Elite;
+
+void Elite::EJobSystem::Run(Job job, JobCounter* pCounter)
+{
+	if (pCounter)
+		++pCounter->m_NrOfPendingJobs;
+
+	Schedule(std::move(job), pCounter);
+}
+
+void Elite::EJobSystem::RunAfter(JobCounter& dependency, Job job, JobCounter* pCounter)
+{
+	{
+		//Finish takes the same lock before it releases the continuations, so none of them get lost
+		std::lock_guard<std::mutex> lock{ dependency.m_ContinuationsMutex };
+		if (!dependency.IsDone())
+		{
+			if (pCounter)
+				++pCounter->m_NrOfPendingJobs;
+			dependency.m_Continuations.push_back({ std::move(job), pCounter });
+			return;
+		}
+	}
+
+	Run(std::move(job), pCounter);
+}
+
+void Elite::EJobSystem::Schedule(Job job, JobCounter* pCounter)
+{
+	m_TaskPool.Submit([this, job = std::move(job), pCounter]()
+	{
+		job();
+		Finish(pCounter);
+	});
+}
+
+void Elite::EJobSystem::Wait(const JobCounter& counter)
+{
+	m_TaskPool.WaitUntil([&counter]() { return counter.IsDone(); });
+
+	//The last job counts down while it holds the lock, once we have it that job is done with the counter
+	std::lock_guard<std::mutex> lock{ counter.m_ContinuationsMutex };
+}
+
+void Elite::EJobSystem::Invoke(const Job& first, const Job& second)
+{
+	JobCounter counter{};
+	Run(first, &counter);
+	second();
+	Wait(counter);
+}
+
+void Elite::EJobSystem::Finish(JobCounter* pCounter)
+{
+	if (!pCounter)
+		return;
+
+	std::vector<JobCounter::Continuation> continuations{};
+	bool isDone = false;
+	{
+		std::lock_guard<std::mutex> lock{ pCounter->m_ContinuationsMutex };
+		isDone = --pCounter->m_NrOfPendingJobs == 0;
+		if (isDone)
+			continuations.swap(pCounter->m_Continuations);
+	}
+
+	//The continuations were already counted when they were held back
+	for (auto& continuation : continuations)
+		Schedule(std::move(continuation.job), continuation.pCounter);
+
+	if (isDone)
+		m_TaskPool.NotifyWaiters();
+}
@@ -0,0 +1,76 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// EJobSystem.h: engine wide job system, spreads simulation work (flocking, pathfinding batches, influence
+// propagation, ...) over all cores. Jobs run on the work-stealing TaskPool, a thread that waits for jobs runs
+// other jobs in the meantime, so waiting from inside a job is fine.
+// Jobs are tracked with JobCounters: running a job counts it up, finishing it counts it down, a job can be held
+// back until another counter reaches zero to express dependencies.
+/*=============================================================================*/
+#ifndef ELITE_JOB_SYSTEM
+#define	ELITE_JOB_SYSTEM
+#include "framework/EliteHelpers/EParallel.h"
+
+namespace Elite
+{
+	using Job = std::function<void()>;
+
+	//Amount of jobs that are still running or waiting, has to outlive the jobs it counts.
+	//Wait on it before destroying it, IsDone alone doesn't guarantee the last job let go of it yet
+	class JobCounter final
+	{
+	public:
+		JobCounter() = default;
+		JobCounter(const JobCounter&) = delete;
+		JobCounter& operator=(const JobCounter&) = delete;
+
+		bool IsDone() const { return m_NrOfPendingJobs == 0; }
+
+	private:
+		friend class EJobSystem;
+
+		struct Continuation
+		{
+			Job job;
+			JobCounter* pCounter;
+		};
+
+		std::atomic<int> m_NrOfPendingJobs{ 0 };
+		mutable std::mutex m_ContinuationsMutex;
+		std::vector<Continuation> m_Continuations; //Jobs waiting for this counter to reach zero
+	};
+
+	class EJobSystem final : public ESingleton<EJobSystem>
+	{
+	public:
+		//=== Constructors & Destructors ===
+		EJobSystem() = default;
+		~EJobSystem() = default;
+
+		//=== Job Functions ===
+		//The counter (when given) counts the job until it finished
+		void Run(Job job, JobCounter* pCounter = nullptr);
+		//Holds the job back until the dependency reaches zero, runs it straight away when it already is
+		void RunAfter(JobCounter& dependency, Job job, JobCounter* pCounter = nullptr);
+		//Runs other jobs on the calling thread until the counter reaches zero
+		void Wait(const JobCounter& counter);
+
+		//Fork/join: runs both, the second one on the calling thread, returns when both are done
+		void Invoke(const Job& first, const Job& second);
+		//See Elite::ParallelFor, on the threads of the job system
+		void ParallelFor(int begin, int end, int grainSize, const std::function<void(int first, int last)>& body)
+		{ Elite::ParallelFor(begin, end, grainSize, body, nullptr, m_TaskPool); }
+
+		unsigned GetConcurrency() const { return m_TaskPool.GetConcurrency(); }
+		TaskPool& GetTaskPool() { return m_TaskPool; }
+
+	private:
+		//=== Datamembers ===
+		TaskPool m_TaskPool{};
+
+		//Submits without counting the job, it counts down when done
+		void Schedule(Job job, JobCounter* pCounter);
+		void Finish(JobCounter* pCounter);
+	};
+}
+#endif
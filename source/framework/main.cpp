@@ -61,6 +61,9 @@ int main(int argc, char* argv[])
 		//Create Physics
 		PHYSICSWORLD; //Boot
 
+		//Start the worker threads
+		JOBSYSTEM;
+
 		//Start Timer
 		TIMER->Start();
 
@@ -117,6 +120,7 @@ int main(int argc, char* argv[])
 		DEBUGRENDERER2D->Destroy();
 		INPUTMANAGER->Destroy();
 		TIMER->Destroy();
+		JOBSYSTEM->Destroy();
 	}
 	catch (const Elite_Exception& e)
 	{
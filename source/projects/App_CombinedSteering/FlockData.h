@@ -0,0 +1,27 @@
+/*=============================================================================*/
+// Copyright 2020-2021 Elite Engine
+/*=============================================================================*/
+// FlockData.h: state of every boid of a flock as a structure of arrays, entry i of every array belongs to agent i
+// of the flock. The flock reads it from the rigid bodies at the start of a step and writes it back once at the end,
+// the flocking behaviours only work on these arrays in between instead of going through Box2D per neighbour.
+/*=============================================================================*/
+#pragma once
+#include <vector>
+#include "framework\EliteMath\EVector2.h"
+
+struct FlockData
+{
+	std::vector<Elite::Vector2> positions;
+	std::vector<Elite::Vector2> linearVelocities;
+	std::vector<float> orientations;
+	std::vector<int> cellIndices; // cell of the space partition the agent is registered in, -1 when it isn't
+
+	int GetSize() const { return int(positions.size()); }
+	void Resize(int size)
+	{
+		positions.resize(size);
+		linearVelocities.resize(size);
+		orientations.resize(size);
+		cellIndices.resize(size, -1);
+	}
+};
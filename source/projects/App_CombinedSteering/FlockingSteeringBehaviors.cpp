@@ -1,22 +1,54 @@
 #include "stdafx.h"
 #include "FlockingSteeringBehaviors.h"
-#include "TheFlock.h"
 #include "../App_Steering/SteeringAgent.h"
 #include "../App_Steering/SteeringHelpers.h"
 
+//******************
+//FLOCK NEIGHBORHOOD
+Elite::Vector2 FlockNeighborhood::GetAverageNeighborPos() const
+{
+	Elite::Vector2 avgNeighbourPos{};
+	if (!neighbors.empty())
+	{
+		for (const int neighborIdx : neighbors)
+		{
+			avgNeighbourPos += pData->positions[neighborIdx];
+		}
+		avgNeighbourPos /= float(neighbors.size());
+	}
+	return avgNeighbourPos;
+}
+
+Elite::Vector2 FlockNeighborhood::GetAverageNeighborVelocity() const
+{
+	Elite::Vector2 avgNeighbourVel{};
+	if (!neighbors.empty())
+	{
+		for (const int neighborIdx : neighbors)
+		{
+			avgNeighbourVel += pData->linearVelocities[neighborIdx];
+		}
+		avgNeighbourVel /= float(neighbors.size());
+	}
+
+	return avgNeighbourVel;
+}
+
 //*********************
 //SEPARATION (FLOCKING)
 SteeringOutput Separation::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 {
 	SteeringOutput steering{};
-	const auto& neighbours{ m_pFlockObj->GetNeighbors() };
-	const int nrNeighbours{ m_pFlockObj->GetNrOfNeighbors() };
+	const auto& neighbours{ m_pNeighborhood->neighbors };
+	const int nrNeighbours{ m_pNeighborhood->GetNrOfNeighbors() };
 	if (nrNeighbours > 0)
 	{
+		const auto& positions{ m_pNeighborhood->pData->positions };
+		const Elite::Vector2 agentPos{ positions[m_pNeighborhood->agentIdx] };
 		Elite::Vector2 avgPosFromThisAgent{};
 		for (int i = 0; i < nrNeighbours; ++i)
 		{
-			avgPosFromThisAgent += pAgent->GetPosition() - neighbours[i]->GetPosition();
+			avgPosFromThisAgent += agentPos - positions[neighbours[i]];
 		}
 		const float magnitude{ avgPosFromThisAgent.Normalize() };
 		if (magnitude > 0)
@@ -35,12 +67,12 @@ SteeringOutput Separation::CalculateSteering(float deltaT, SteeringAgent* pAgent
 SteeringOutput Cohesion::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 {
 	SteeringOutput steering{};
-	const int nrNeighbour{ m_pFlockObj->GetNrOfNeighbors() };
+	const int nrNeighbour{ m_pNeighborhood->GetNrOfNeighbors() };
 	if (nrNeighbour > 0)
 	{
-		const Elite::Vector2 averagePos{ m_pFlockObj->GetAverageNeighborPos() };
+		const Elite::Vector2 averagePos{ m_pNeighborhood->GetAverageNeighborPos() };
 
-		steering.LinearVelocity = averagePos - pAgent->GetPosition();
+		steering.LinearVelocity = averagePos - m_pNeighborhood->pData->positions[m_pNeighborhood->agentIdx];
 		steering.LinearVelocity.Normalize();
 		steering.LinearVelocity *= pAgent->GetMaxLinearSpeed();
 	}
@@ -53,10 +85,10 @@ SteeringOutput Cohesion::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 SteeringOutput Alignment::CalculateSteering(float deltaT, SteeringAgent* pAgent)
 {
 	SteeringOutput steering{};
-	const int nrNeighbours{ m_pFlockObj->GetNrOfNeighbors() };
+	const int nrNeighbours{ m_pNeighborhood->GetNrOfNeighbors() };
 	if (nrNeighbours > 0)
 	{
-		const auto avgVelocity{ m_pFlockObj->GetAverageNeighborVelocity() };
+		const auto avgVelocity{ m_pNeighborhood->GetAverageNeighborVelocity() };
 
 		steering.LinearVelocity = avgVelocity;
 		steering.LinearVelocity.Normalize();
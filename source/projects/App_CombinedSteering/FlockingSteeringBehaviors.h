@@ -1,23 +1,34 @@
 #pragma once
 #include "../App_Steering/SteeringBehaviors.h"
+#include "FlockData.h"
+
+// The agent that is being steered and its neighbours, as indices in the flock data. That data holds the state from
+// the start of the flock step, so it doesn't matter in which order (or on which thread) the agents get steered
+struct FlockNeighborhood
+{
+	const FlockData* pData = nullptr;
+	int agentIdx = -1;
+	std::vector<int> neighbors;
+
+	int GetNrOfNeighbors() const { return int(neighbors.size()); }
+	Elite::Vector2 GetAverageNeighborPos() const;
+	Elite::Vector2 GetAverageNeighborVelocity() const;
+};
 
-class Flock;
 class IFlocking : public ISteeringBehavior
 {
 public:
 
-	IFlocking(Flock* pSelf)
-		: m_pFlockObj(pSelf)
+	IFlocking(const FlockNeighborhood* pNeighborhood)
+		: m_pNeighborhood(pNeighborhood)
 	{
 	}
 
 	virtual ~IFlocking() = default;
-	void SetNeighbours(const std::vector<SteeringAgent*>& neighbours) { m_Neighbours = &neighbours; }
 
 protected:
 
-	Flock* m_pFlockObj; // Behaviour doesn't own this flock object
-	std::vector<SteeringAgent*>const * m_Neighbours{};
+	const FlockNeighborhood* m_pNeighborhood; // Behaviour doesn't own the neighbourhood, the flock fills it in per agent
 };
 
 //SEPARATION - FLOCKING
@@ -26,8 +37,8 @@ class Separation : public IFlocking
 {
 public:
 
-	Separation(Flock* pSelf)
-		: IFlocking(pSelf)
+	Separation(const FlockNeighborhood* pNeighborhood)
+		: IFlocking(pNeighborhood)
 	{
 	}
 
@@ -45,8 +56,8 @@ class Cohesion : public IFlocking
 {
 public:
 
-	Cohesion(Flock* pSelf)
-		: IFlocking(pSelf)
+	Cohesion(const FlockNeighborhood* pNeighborhood)
+		: IFlocking(pNeighborhood)
 	{
 	}
 
@@ -63,8 +74,8 @@ class Alignment : public IFlocking
 {
 public:
 
-	Alignment(Flock* pFlock)
-		: IFlocking(pFlock)
+	Alignment(const FlockNeighborhood* pNeighborhood)
+		: IFlocking(pNeighborhood)
 	{
 	}
 
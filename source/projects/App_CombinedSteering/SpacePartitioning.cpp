@@ -1,6 +1,5 @@
 #include "stdafx.h"
 #include "SpacePartitioning.h"
-#include "projects\App_Steering\SteeringAgent.h"
 
 // --- Cell ---
 // ------------
@@ -37,8 +36,6 @@ CellSpace::CellSpace(float width, float height, int rows, int cols, int maxEntit
 	, m_SpaceHeight(height)
 	, m_NrOfRows(rows)
 	, m_NrOfCols(cols)
-	, m_Neighbors(maxEntities)
-	, m_NrOfNeighbors(0)
 {
 	m_CellHeight = height * 2.0f / float(rows);
 	m_CellWidth = width * 2.0f / float(cols);
@@ -59,63 +56,59 @@ CellSpace::CellSpace(float width, float height, int rows, int cols, int maxEntit
 	}
 }
 
-void CellSpace::AddAgent(SteeringAgent* agent)
+int CellSpace::AddAgent(int agentIdx, const Elite::Vector2& pos)
 {
-	const auto agentPos{ agent->GetPosition() };
-	const int index{ PositionToIndex(agentPos) };
-	if(index > 0)
+	const int index{ PositionToIndex(pos) };
+	if(index >= 0)
 	{
 		auto& cell{ m_Cells[index].agents };
-		const auto it = std::find(cell.begin(), cell.end(), agent);
+		const auto it = std::find(cell.begin(), cell.end(), agentIdx);
 		if (it == cell.end())
-			cell.emplace_back(agent);
+			cell.emplace_back(agentIdx);
 	}
+	return index;
 }
 
-void CellSpace::UpdateAgentCell(SteeringAgent* agent, const Elite::Vector2& oldPos)
+int CellSpace::UpdateAgentCell(int agentIdx, int oldCellIdx, const Elite::Vector2& newPos)
 {
-	const int oldCellIndex{ agent->GetOldCellIndex() };
-	const auto currentPos{ agent->GetPosition() };
-	const int currentCellIndex{ PositionToIndex(currentPos)};
+	const int currentCellIndex{ PositionToIndex(newPos) };
+	if (oldCellIdx == currentCellIndex)
+		return currentCellIndex;
 
-	if(oldCellIndex >= 0 && currentCellIndex >= 0)
+	// Delete the agent from the old cell and add in to new one, the order within a cell doesn't matter
+	if (oldCellIdx >= 0)
 	{
-		if (oldCellIndex != currentCellIndex)
+		auto& oldCell{ m_Cells[oldCellIdx].agents };
+		const auto it = std::find(oldCell.begin(), oldCell.end(), agentIdx);
+		if (it != oldCell.end())
 		{
-			// Delete the agent from the old cell and add in to new one
-			m_Cells[currentCellIndex].agents.emplace_back(agent);
-			m_Cells[oldCellIndex].agents.remove(agent);
+			*it = oldCell.back();
+			oldCell.pop_back();
 		}
-
-		//ImGui::Value("OldPosX", oldPos.x);
-		//ImGui::Value("OldPosY", oldPos.y);
-
-		//ImGui::Value("Current PosX", currentPos.x);
-		//ImGui::Value("Current PosY", currentPos.y);
-		//
-		//ImGui::Value("Old Index: ", oldCellIndex);
-		//ImGui::Value("Current Index: ", currentCellIndex);
-
-		agent->SetOldCellIndex(currentCellIndex);
 	}
 
+	if (currentCellIndex >= 0)
+		m_Cells[currentCellIndex].agents.emplace_back(agentIdx);
 
+	return currentCellIndex;
 }
 
-void CellSpace::RegisterNeighbors(SteeringAgent* pAgent, const Elite::Vector2& targetPos, float queryRadius)
+void CellSpace::RegisterNeighbors(int agentIdx, const Elite::Vector2& targetPos, float queryRadius, std::vector<int>& neighbors) const
 {
-	m_NrOfNeighbors = 0;
+	neighbors.clear();
 	const auto currentCellIndex{ PositionToIndex(targetPos) };
+	if (currentCellIndex < 0)
+		return;
 
 	// Just that one condition where the query radius is inside one cell
 	if (queryRadius <= m_CellWidth)
 	{
-		const auto currentAgentsInCell{ m_Cells[currentCellIndex].agents };
+		const auto& currentAgentsInCell{ m_Cells[currentCellIndex].agents };
 
-		for (const auto& agent : currentAgentsInCell)
+		for (const int agent : currentAgentsInCell)
 		{
-			if(pAgent != agent)
-				m_Neighbors[m_NrOfNeighbors++] = agent;
+			if(agentIdx != agent)
+				neighbors.push_back(agent);
 		}
 
 		return;
@@ -134,10 +127,10 @@ void CellSpace::RegisterNeighbors(SteeringAgent* pAgent, const Elite::Vector2& t
 				const auto& agentsInCell{ m_Cells[traverseIndex].agents };
 				if(agentsInCell.empty()) continue;
 				
-				for (const auto& agent : agentsInCell)
+				for (const int agent : agentsInCell)
 				{
-					if(agent != pAgent)
-						m_Neighbors[m_NrOfNeighbors++] = agent;
+					if(agent != agentIdx)
+						neighbors.push_back(agent);
 				}
 			}
 		}
@@ -162,9 +155,9 @@ void CellSpace::RenderCells() const
 	}
 }
 
-void CellSpace::RenderNeighbourHoodCells(SteeringAgent* pAgent, float queryRadius)
+void CellSpace::RenderNeighbourHoodCells(const Elite::Vector2& pos, float queryRadius)
 {
-	const int currentCellIndex{ PositionToIndex(pAgent->GetPosition()) };
+	const int currentCellIndex{ PositionToIndex(pos) };
 	
 	const auto maxSurroundCellIndex{ abs(int(floorf((queryRadius / m_CellWidth)))) };
 	const auto maxCells{ (m_NrOfCols * m_NrOfRows) - 1 };
@@ -3,21 +3,18 @@
 // Authors: Yosha Vandaele
 /*=============================================================================*/
 // SpacePartitioning.h: Contains Cell and Cellspace which are used to partition a space in segments.
-// Cells contain pointers to all the agents within.
+// Cells contain the indices of all the agents within, in the arrays of the flock.
 // These are used to avoid unnecessary distance comparisons to agents that are far away.
 
 // Heavily based on chapter 3 of "Programming Game AI by Example" - Mat Buckland
 /*=============================================================================*/
 
 #pragma once
-#include <list>
 #include <vector>
 #include <iterator>
 #include "framework\EliteMath\EVector2.h"
 #include "framework\EliteGeometry\EGeometry2DTypes.h"
 
-class SteeringAgent;
-
 // --- Cell ---
 // ------------
 struct Cell
@@ -28,7 +25,7 @@ struct Cell
 	std::vector<Elite::Vector2> GetRectPoints() const;
 	
 	// all the agents currently in this cell
-	std::list<SteeringAgent*> agents;
+	std::vector<int> agents;
 	Elite::Rect boundingBox;
 };
 
@@ -39,15 +36,15 @@ class CellSpace
 public:
 	CellSpace(float width, float height, int rows, int cols, int maxEntities);
 
-	void AddAgent(SteeringAgent* agent);
-	void UpdateAgentCell(SteeringAgent* agent, const Elite::Vector2& oldPos);
+	// Both return the cell the agent ends up in, -1 when the position is outside of the space
+	int AddAgent(int agentIdx, const Elite::Vector2& pos);
+	int UpdateAgentCell(int agentIdx, int oldCellIdx, const Elite::Vector2& newPos);
 
-	void RegisterNeighbors(SteeringAgent* pAgent,const Elite::Vector2& targetPos, float queryRadius);
-	const std::vector<SteeringAgent*>& GetNeighbors() const { return m_Neighbors; }
-	int GetNrOfNeighbors() const { return m_NrOfNeighbors; }
+	// the caller owns the neighbour buffer, so agents can look for their neighbours at the same time
+	void RegisterNeighbors(int agentIdx, const Elite::Vector2& targetPos, float queryRadius, std::vector<int>& neighbors) const;
 
 	void RenderCells()const;
-	void RenderNeighbourHoodCells(SteeringAgent* pAgent, float queryRadius);
+	void RenderNeighbourHoodCells(const Elite::Vector2& pos, float queryRadius);
 
 private:
 	
@@ -63,10 +60,6 @@ private:
 	float m_CellWidth;
 	float m_CellHeight;
 
-	// Members to avoid memory allocation on every frame
-	vector<SteeringAgent*> m_Neighbors;
-	int m_NrOfNeighbors;
-
 	// Helper functions
 	int PositionToIndex(const Elite::Vector2 pos) const;
 };
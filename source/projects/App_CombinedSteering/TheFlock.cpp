@@ -8,6 +8,19 @@
 using namespace Elite;
 
 //Constructor & Destructor
+Flock::SteeringContext::SteeringContext()
+	: blendedSteering({
+		{&cohesion,0.2f},
+		{&separation,0.2f},
+		{&alignment,0.2f},
+		{&wander,0.2f},
+		{&seek,1.0f}
+		})
+	, prioritySteering({ &evade,&blendedSteering })
+{
+	evade.SetUseFleeRadius(true);
+}
+
 Flock::Flock(
 	int flockSize /*= 50*/,
 	float worldSize /*= 100.f*/,
@@ -16,42 +29,24 @@ Flock::Flock(
 
 	: m_FlockSize{ flockSize }
 	, m_NeighborhoodRadius{ 15 }
-	, m_NrOfNeighbors{ 0 }
 	, m_pAgentToEvade{ pAgentToEvade }
 	, m_TrimWorld{ trimWorld }
 	, m_WorldSize{ worldSize }
 	, m_SpacePartition(worldSize, worldSize, 25, 25, flockSize)
 {
-	// !! Wouldn't work with smart pointer
-	// can't create object using unpossessed object
-	m_pCohesion = new Cohesion(this);
-	m_pSeparation = new Separation(this);
-	m_pAlignment = new Alignment(this);
-	m_pWander = new Wander();
-	m_pSeek = new Seek();
-	m_pSeek->SetTarget(m_MouseTarget);
-
-	m_pBlendedSteering = new BlendedSteering({
-		{m_pCohesion,0.2f},
-		{m_pSeparation,0.2f},
-		{m_pAlignment,0.2f},
-		{m_pWander,0.2f},
-		{m_pSeek,1.0f}
-		});
-
-
-	m_pEvade = new Evade();
-	m_pEvade->SetUseFleeRadius(true);
-	TargetData evadeTarget{};
-	evadeTarget.LinearVelocity = m_pAgentToEvade->GetLinearVelocity();
-	evadeTarget.Position = m_pAgentToEvade->GetPosition();
-	evadeTarget.Orientation = m_pAgentToEvade->GetOrientation();
-	m_pEvade->SetTarget(evadeTarget);
-	m_pEvade->SetFleeRadius(m_NeighborhoodRadius);
+	const int nrOfChunks{ (flockSize + m_AgentsPerChunk - 1) / m_AgentsPerChunk };
+	for (int i = 0; i < std::max(nrOfChunks, 1); ++i)
+		m_Contexts.push_back(std::make_unique<SteeringContext>());
 
-	m_pPrioritySteering = new PrioritySteering({ m_pEvade,m_pBlendedSteering });
+	for (auto& pContext : m_Contexts)
+		pContext->neighborhood.pData = &m_Data;
+	m_DebugNeighborhood.pData = &m_Data;
+
+	SyncContexts();
 
 	m_Agents = std::vector<SteeringAgent*>{ size_t(flockSize) };
+	m_SteeringOutputs = std::vector<SteeringOutput>{ size_t(flockSize) };
+	m_Data.Resize(flockSize);
 
 	for (int i = 0; i < flockSize; ++i)
 	{
@@ -62,36 +57,27 @@ Flock::Flock(
 		steerAgent->SetMass(1.0f);
 		steerAgent->SetBodyColor({ 1.0f,1.0f,0.0f });
 		steerAgent->SetMaxLinearSpeed(50.0f);
-		steerAgent->SetSteeringBehavior(m_pPrioritySteering);
+		steerAgent->SetSteeringBehavior(&m_Contexts[i / m_AgentsPerChunk]->prioritySteering);
 		steerAgent->SetPosition(randPos);
 
 		m_Agents[i] = steerAgent;
+		m_Data.positions[i] = randPos;
+		m_Data.cellIndices[i] = m_SpacePartition.AddAgent(i, randPos);
 	}
-
-	m_Neighbors = std::vector<SteeringAgent*>{ size_t(flockSize) };
 }
 
 Flock::~Flock()
 {
 	for (auto& agent : m_Agents)
 		SAFE_DELETE(agent)
-
-		SAFE_DELETE(m_pEvade)
-		SAFE_DELETE(m_pSeek)
-		SAFE_DELETE(m_pAlignment)
-		SAFE_DELETE(m_pCohesion)
-		SAFE_DELETE(m_pSeparation)
-		SAFE_DELETE(m_pWander)
-		SAFE_DELETE(m_pBlendedSteering)
-		SAFE_DELETE(m_pPrioritySteering)
 }
 
 void Flock::Update(float deltaT)
 {
-	// loop over all the boids
-	// register its neighbors
-	// update it
-	// trim it to the world
+	// 1. read the state of every boid from its rigid body into the flock data
+	// 2. steer every boid in parallel, neighbours are only read from the flock data
+	// 3. integrate the steering into the flock data in parallel
+	// 4. write the velocities and orientations back to the rigid bodies, on this thread since they share the physics world
 
 	//INPUT
 	if (INPUTMANAGER->IsMouseButtonUp(InputMouseButton::eLeft))
@@ -99,37 +85,60 @@ void Flock::Update(float deltaT)
 		auto const mouseData = INPUTMANAGER->GetMouseData(InputType::eMouseButton, InputMouseButton::eLeft);
 		m_MouseTarget.Position = DEBUGRENDERER2D->GetActiveCamera()->
 			ConvertScreenToWorld({ static_cast<float>(mouseData.X), static_cast<float>(mouseData.Y) });
-		m_pSeek->SetTarget(m_MouseTarget);
 	}
 
-	TargetData evadeTarget{};
-	evadeTarget.LinearVelocity = m_pAgentToEvade->GetLinearVelocity();
-	evadeTarget.Position = m_pAgentToEvade->GetPosition();
-	evadeTarget.Orientation = m_pAgentToEvade->GetOrientation();
-
-	m_pEvade->SetTarget(evadeTarget);
+	SyncContexts();
 
+	JOBSYSTEM->ParallelFor(0, m_FlockSize, m_AgentsPerChunk * 4, [this](int first, int last)
+	{
+		for (int i = first; i < last; ++i)
+		{
+			m_Data.positions[i] = m_Agents[i]->GetPosition();
+			m_Data.linearVelocities[i] = m_Agents[i]->GetLinearVelocity();
+			m_Data.orientations[i] = m_Agents[i]->GetRotation();
+		}
+	});
 
-	for (const auto& boi : m_Agents)
+	if (m_UseSpacePartition)
 	{
-		const auto agentPos{ boi->GetPosition() };
+		for (int i = 0; i < m_FlockSize; ++i)
+			m_Data.cellIndices[i] = m_SpacePartition.UpdateAgentCell(i, m_Data.cellIndices[i], m_Data.positions[i]);
+	}
 
-		if (m_UseSpacePartition)
+	// the chunks match the contexts, so no two threads share behaviours
+	JOBSYSTEM->ParallelFor(0, m_FlockSize, m_AgentsPerChunk, [this, deltaT](int first, int last)
+	{
+		SteeringContext& context = *m_Contexts[first / m_AgentsPerChunk];
+		for (int i = first; i < last; ++i)
 		{
-			m_SpacePartition.UpdateAgentCell(boi, agentPos);
-			m_SpacePartition.RegisterNeighbors(boi,agentPos, m_NeighborhoodRadius);
-			m_Neighbors = m_SpacePartition.GetNeighbors();
-			m_NrOfNeighbors = m_SpacePartition.GetNrOfNeighbors();
+			RegisterNeighbors(i, context.neighborhood);
+			m_SteeringOutputs[i] = m_Agents[i]->CalculateSteering(deltaT);
 		}
-		else
+	});
+
+	// linear part of SteeringAgent::ApplySteering, flock agents always orient along their velocity
+	JOBSYSTEM->ParallelFor(0, m_FlockSize, m_AgentsPerChunk * 4, [this, deltaT](int first, int last)
+	{
+		for (int i = first; i < last; ++i)
 		{
-			RegisterNeighbors(boi);
+			auto& linVel = m_Data.linearVelocities[i];
+			const auto acceleration = (m_SteeringOutputs[i].LinearVelocity - linVel) / m_Agents[i]->GetMass();
+			linVel += acceleration * deltaT;
 		}
-		
-		boi->Update(deltaT); // only updates steering
+	});
+
+	for (int i = 0; i < m_FlockSize; ++i)
+	{
+		m_Agents[i]->SetLinearVelocity(m_Data.linearVelocities[i]);
 
-		if (m_TrimWorld)
-			boi->TrimToWorld(m_WorldSize);
+		// the wrapped position and the new orientation go in one transform, boids that neither turned nor left the world skip it
+		const auto position{ m_TrimWorld ? SteeringAgent::GetTrimmedPosition(m_Data.positions[i], { m_WorldSize, m_WorldSize }) : m_Data.positions[i] };
+		const auto orientation{ Elite::GetOrientationFromVelocity(m_Data.linearVelocities[i]) };
+		if (position != m_Data.positions[i] || orientation != m_Data.orientations[i])
+			m_Agents[i]->SetTransform(position, orientation);
+
+		m_Data.positions[i] = position;
+		m_Data.orientations[i] = orientation;
 	}
 }
 
@@ -158,9 +167,7 @@ void Flock::Render(float deltaT)
 		{
 			const auto agentPos{ sampleAgent->GetPosition() };
 			debugColor = Color(0.96f,0.59f,0.93f);
-			m_SpacePartition.RegisterNeighbors(sampleAgent,agentPos, m_NeighborhoodRadius);
-			m_Neighbors = m_SpacePartition.GetNeighbors();
-			m_NrOfNeighbors = m_SpacePartition.GetNrOfNeighbors();
+			RegisterNeighbors(0, m_DebugNeighborhood);
 
 			// Render bounding box
 			const Elite::Vector2 rect[4]
@@ -173,18 +180,18 @@ void Flock::Render(float deltaT)
 			
 			DEBUGRENDERER2D->DrawPolygon(rect, 4, { 0.0f,0.0f,1.0f }, 0.4f);
 			
-			m_SpacePartition.RenderNeighbourHoodCells(sampleAgent, m_NeighborhoodRadius);
+			m_SpacePartition.RenderNeighbourHoodCells(agentPos, m_NeighborhoodRadius);
 			m_SpacePartition.RenderCells();
 		}
 		else
 		{
 			debugColor = Color(0.0f, 1.0f, 1.0f);
-			RegisterNeighbors(sampleAgent);
+			RegisterNeighbors(0, m_DebugNeighborhood);
 		}
 
 		sampleAgent->SetBodyColor(debugColor);
-		for (int i = 0; i < m_NrOfNeighbors; ++i)
-			m_Neighbors[i]->SetBodyColor({ 0.2f,0.8f,0.0f });
+		for (const int neighborIdx : m_DebugNeighborhood.neighbors)
+			m_Agents[neighborIdx]->SetBodyColor({ 0.2f,0.8f,0.0f });
 
 		for (const auto& boi : m_Agents)
 			boi->Render(deltaT);
@@ -241,19 +248,19 @@ void Flock::UpdateAndRenderUI()
 	ImGui::Spacing();
 
 	// Implement checkboxes and sliders here
-	ImGui::SliderFloat("Cohesion", GetWeight(m_pCohesion), 0.0f, 1.0f);
+	ImGui::SliderFloat("Cohesion", GetWeight(&m_Contexts[0]->cohesion), 0.0f, 1.0f);
 	ImGui::Spacing();
 
-	ImGui::SliderFloat("Separation", GetWeight(m_pSeparation), 0.0f, 1.0f);
+	ImGui::SliderFloat("Separation", GetWeight(&m_Contexts[0]->separation), 0.0f, 1.0f);
 	ImGui::Spacing();
 
-	ImGui::SliderFloat("Alignment", GetWeight(m_pAlignment), 0.0f, 1.0f);
+	ImGui::SliderFloat("Alignment", GetWeight(&m_Contexts[0]->alignment), 0.0f, 1.0f);
 	ImGui::Spacing();
 
-	ImGui::SliderFloat("Wander", GetWeight(m_pWander), 0.0f, 1.0f);
+	ImGui::SliderFloat("Wander", GetWeight(&m_Contexts[0]->wander), 0.0f, 1.0f);
 	ImGui::Spacing();
 
-	ImGui::SliderFloat("Seek", GetWeight(m_pSeek), 0.0f, 1.0f);
+	ImGui::SliderFloat("Seek", GetWeight(&m_Contexts[0]->seek), 0.0f, 1.0f);
 	ImGui::Spacing();
 
 	ImGui::Separator();
@@ -269,69 +276,60 @@ void Flock::UpdateAndRenderUI()
 	ImGui::End();
 }
 
-void Flock::RegisterNeighbors(SteeringAgent* pAgent)
+void Flock::RegisterNeighbors(int agentIdx, FlockNeighborhood& neighborhood) const
 {
-	// register the agents neighboring the currently evaluated agent
-	// store how many they are, so you know which part of the vector to loop over
-	m_NrOfNeighbors = 0;
-	for (int i = 0; i < m_FlockSize; ++i)
+	// register the agents neighboring the currently evaluated agent, at the positions read for this step
+	neighborhood.agentIdx = agentIdx;
+	const auto agentPos{ m_Data.positions[agentIdx] };
+	if (m_UseSpacePartition)
 	{
-		if (m_Agents[i] != pAgent)
-		{
-			const auto vecToNeighbour{ m_Agents[i]->GetPosition() - pAgent->GetPosition() };
-			if (vecToNeighbour.MagnitudeSquared() <= m_NeighborhoodRadius * m_NeighborhoodRadius)
-				m_Neighbors[m_NrOfNeighbors++] = m_Agents[i];
-
-		}
+		m_SpacePartition.RegisterNeighbors(agentIdx, agentPos, m_NeighborhoodRadius, neighborhood.neighbors);
+		return;
 	}
-}
 
-Elite::Vector2 Flock::GetAverageNeighborPos() const
-{
-	Elite::Vector2 avgNeighbourPos{};
-	if (m_NrOfNeighbors > 0)
+	neighborhood.neighbors.clear();
+	const float radiusSquared{ m_NeighborhoodRadius * m_NeighborhoodRadius };
+	for (int i = 0; i < m_FlockSize; ++i)
 	{
-		for (int i = 0; i < m_NrOfNeighbors; ++i)
-		{
-			avgNeighbourPos += m_Neighbors[i]->GetPosition();
-		}
-		avgNeighbourPos /= float(m_NrOfNeighbors);
+		if (i != agentIdx && (m_Data.positions[i] - agentPos).MagnitudeSquared() <= radiusSquared)
+			neighborhood.neighbors.push_back(i);
 	}
-	return avgNeighbourPos;
 }
 
-Elite::Vector2 Flock::GetAverageNeighborVelocity() const
+float* Flock::GetWeight(ISteeringBehavior* pBehavior)
 {
-	Elite::Vector2 avgNeighbourVel{};
-	if (m_NrOfNeighbors > 0)
-	{
-		for (int i = 0; i < m_NrOfNeighbors; ++i)
+	auto& weightedBehaviors = m_Contexts[0]->blendedSteering.m_WeightedBehaviors;
+	auto it = find_if(weightedBehaviors.begin(),
+		weightedBehaviors.end(),
+		[pBehavior](BlendedSteering::WeightedBehavior el)
 		{
-			avgNeighbourVel += m_Neighbors[i]->GetLinearVelocity();
+			return el.pBehavior == pBehavior;
 		}
-		avgNeighbourVel /= float(m_NrOfNeighbors);
-	}
+	);
 
-	return avgNeighbourVel;
-}
+	if (it != weightedBehaviors.end())
+		return &it->weight;
 
+	return nullptr;
+}
 
-float* Flock::GetWeight(ISteeringBehavior* pBehavior)
+void Flock::SyncContexts()
 {
-	if (m_pBlendedSteering)
-	{
-		auto& weightedBehaviors = m_pBlendedSteering->m_WeightedBehaviors;
-		auto it = find_if(weightedBehaviors.begin(),
-			weightedBehaviors.end(),
-			[pBehavior](BlendedSteering::WeightedBehavior el)
-			{
-				return el.pBehavior == pBehavior;
-			}
-		);
+	TargetData evadeTarget{};
+	evadeTarget.LinearVelocity = m_pAgentToEvade->GetLinearVelocity();
+	evadeTarget.Position = m_pAgentToEvade->GetPosition();
+	evadeTarget.Orientation = m_pAgentToEvade->GetOrientation();
 
-		if (it != weightedBehaviors.end())
-			return &it->weight;
+	const auto& weightedBehaviors = m_Contexts[0]->blendedSteering.m_WeightedBehaviors;
+	for (auto& pContext : m_Contexts)
+	{
+		pContext->seek.SetTarget(m_MouseTarget);
+		pContext->evade.SetTarget(evadeTarget);
+		pContext->evade.SetFleeRadius(m_NeighborhoodRadius);
+
+		// the behaviours are in the same order in every context
+		auto& contextBehaviors = pContext->blendedSteering.m_WeightedBehaviors;
+		for (size_t i = 0; i < weightedBehaviors.size(); ++i)
+			contextBehaviors[i].weight = weightedBehaviors[i].weight;
 	}
-
-	return nullptr;
 }
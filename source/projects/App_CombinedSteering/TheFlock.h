@@ -1,12 +1,11 @@
 #pragma once
 #include "../App_Steering/SteeringHelpers.h"
 #include "FlockingSteeringBehaviors.h"
+#include "CombinedSteeringBehaviors.h"
 #include "SpacePartitioning.h"
 
 class ISteeringBehavior;
 class SteeringAgent;
-class BlendedSteering;
-class PrioritySteering;
 
 class Flock
 {
@@ -23,23 +22,36 @@ public:
 	void UpdateAndRenderUI();
 	void Render(float deltaT);
 
-	void RegisterNeighbors(SteeringAgent* pAgent);
-	int GetNrOfNeighbors() const { return m_NrOfNeighbors; }
-	const vector<SteeringAgent*>& GetNeighbors() const { return m_Neighbors; }
-
-	Elite::Vector2 GetAverageNeighborPos() const;
-	Elite::Vector2 GetAverageNeighborVelocity() const;
+	void RegisterNeighbors(int agentIdx, FlockNeighborhood& neighborhood) const;
 
 private:
+	// Agents are steered in chunks on the job system, every chunk gets its own copy of the behaviours
+	// (Wander and the neighbourhood keep state while steering an agent)
+	static constexpr int m_AgentsPerChunk = 64;
+
+	struct SteeringContext
+	{
+		SteeringContext();
+
+		FlockNeighborhood neighborhood;
+		Cohesion cohesion{ &neighborhood };
+		Separation separation{ &neighborhood };
+		Alignment alignment{ &neighborhood };
+		Wander wander;
+		Seek seek;
+		Evade evade;
+		BlendedSteering blendedSteering;
+		PrioritySteering prioritySteering;
+	};
 
-	// flock agents
+	// flock agents, the behaviours work on the data and the rigid bodies get synced once per step
 	int m_FlockSize = 0;
 	vector<SteeringAgent*> m_Agents;
+	FlockData m_Data;
 
 	// neighborhood agents
-	vector<SteeringAgent*> m_Neighbors;
 	float m_NeighborhoodRadius = 10.f;
-	int m_NrOfNeighbors = 0;
+	FlockNeighborhood m_DebugNeighborhood; // neighbours of the agent shown by the debug rendering
 
 	// evade target
 	SteeringAgent* m_pAgentToEvade = nullptr;
@@ -51,15 +63,9 @@ private:
 	// mouse position
 	TargetData m_MouseTarget;
 	
-	// steering Behaviors
-	BlendedSteering* m_pBlendedSteering = nullptr;
-	PrioritySteering* m_pPrioritySteering = nullptr;
-	Cohesion* m_pCohesion = nullptr;
-	Separation* m_pSeparation = nullptr;
-	Alignment* m_pAlignment = nullptr;
-	Wander* m_pWander = nullptr;
-	Evade* m_pEvade = nullptr;
-	Seek* m_pSeek = nullptr;
+	// steering Behaviors, the UI edits the first context and the others copy its weights
+	vector<std::unique_ptr<SteeringContext>> m_Contexts;
+	vector<SteeringOutput> m_SteeringOutputs;
 
 	// Cell
 	CellSpace m_SpacePartition;
@@ -69,6 +75,7 @@ private:
 	
 	// private functions
 	float* GetWeight(ISteeringBehavior* pBehaviour);
+	void SyncContexts();
 
 private:
 	Flock(const Flock& other);
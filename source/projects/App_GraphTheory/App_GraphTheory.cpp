@@ -26,9 +26,9 @@ void App_GraphTheory::Start()
 
 	// Initialize Graph
 	m_pGraph2D = new Graph2D<GraphNode2D, GraphConnection2D>{false};
-	m_pGraph2D->AddNode(new GraphNode2D(0, { 20.0f,30.0f }));
-	m_pGraph2D->AddNode(new GraphNode2D(1, { -10.0f,-10.0f }));
-	m_pGraph2D->AddConnection(new GraphConnection2D(0, 1));
+	m_pGraph2D->AddNode(m_pGraph2D->CreateNode(0, Elite::Vector2{ 20.0f,30.0f }));
+	m_pGraph2D->AddNode(m_pGraph2D->CreateNode(1, Elite::Vector2{ -10.0f,-10.0f }));
+	m_pGraph2D->AddConnection(m_pGraph2D->CreateConnection(0, 1));
 
 	m_pEulerFinder = new EulerianPath<GraphNode2D, GraphConnection2D>(m_pGraph2D);
 }
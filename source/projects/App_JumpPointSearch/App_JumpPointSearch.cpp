@@ -1,9 +1,12 @@
 #include "stdafx.h"
 #include "App_JumpPointSearch.h"
 #include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/EJumpPointSearch.h"
+#include "framework/EliteAI/EliteNavigation/Algorithms/EGridPathSmoothing.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/ELazyThetaStar.h"
 
 App_JumpPointSearch::~App_JumpPointSearch()
 {
+	SAFE_DELETE(m_pSubgoalGraph)
 	SAFE_DELETE(m_pGridGraph)
 }
 
@@ -13,7 +16,7 @@ void App_JumpPointSearch::Start()
 	DEBUGRENDERER2D->GetActiveCamera()->SetCenter(Elite::Vector2(73.0f, 35.0f));
 
 	// Make Grid Graph
-	m_pGridGraph = new Elite::GridGraph<Elite::GridTerrainNode, Elite::GraphConnection>(
+	m_pGridGraph = new Elite::GridGraph<Elite::CompactGridNode, Elite::CompactGraphConnection>(
 		m_Columns,
 		m_Rows,
 		m_CellSize,
@@ -65,13 +68,53 @@ void App_JumpPointSearch::Update(float deltaTime)
 		endPathIdx != invalid_node_index &&
 		startPathIdx != endPathIdx)
 	{
-		auto pathfinder{ JumpPointSearch<Elite::GridTerrainNode,Elite::GraphConnection>(m_pGridGraph,m_pHeuristicFunction,m_Columns,m_Rows) };
-		m_vPath = pathfinder.FindPath(
-			m_pGridGraph->GetNode(startPathIdx),
-			m_pGridGraph->GetNode(endPathIdx)
-		);
+		m_IsSubgoalGraphBypassed = false;
+		if (m_IsUsingSubgoalGraph)
+		{
+			// the grid can be edited at any time, the subgoals only get rebuilt when its change journal moved on
+			if (!m_pSubgoalGraph)
+				m_pSubgoalGraph = new Elite::SubgoalGraph<Elite::CompactGridNode, Elite::CompactGraphConnection>(m_pGridGraph, m_pHeuristicFunction);
+			else
+				m_pSubgoalGraph->Update();
+
+			// the subgoals only give shortest paths on ground and have no closest reachable fallback, JPS handles those
+			m_IsSubgoalGraphBypassed = !m_pSubgoalGraph->IsUniformCost()
+				|| (m_IsFallingBackToClosest && !m_pGridGraph->AreConnected(startPathIdx, endPathIdx));
+		}
+
+		if (m_IsUsingSubgoalGraph && !m_IsSubgoalGraphBypassed)
+		{
+			m_vPath = m_pSubgoalGraph->FindPath(
+				m_pGridGraph->GetNode(startPathIdx),
+				m_pGridGraph->GetNode(endPathIdx)
+			);
+
+			// no jump points were made for this path
+			m_JumpPoints.clear();
+		}
+		else
+		{
+			auto pathfinder{ JumpPointSearch<Elite::CompactGridNode, Elite::CompactGraphConnection>(m_pGridGraph,m_pHeuristicFunction,m_Columns,m_Rows,m_IsTerrainAware) };
+			m_vPath = pathfinder.FindPath(
+				m_pGridGraph->GetNode(startPathIdx),
+				m_pGridGraph->GetNode(endPathIdx),
+				false,
+				m_IsFallingBackToClosest
+			);
+
+			m_JumpPoints = pathfinder.GetJumpPoints();
+		}
 
-		m_JumpPoints = pathfinder.GetJumpPoints();
+		m_vWaypoints = Elite::GridPathSmoothing::SmoothPath(m_pGridGraph, m_vPath);
+
+		if (m_IsAnyAngle)
+		{
+			auto anyAnglePathfinder{ Elite::LazyThetaStar<Elite::CompactGridNode, Elite::CompactGraphConnection>(m_pGridGraph, Elite::HeuristicFunctions::Euclidean) };
+			m_vWaypoints = anyAnglePathfinder.FindPath(
+				m_pGridGraph->GetNode(startPathIdx),
+				m_pGridGraph->GetNode(endPathIdx)
+			);
+		}
 		
 		m_ShouldUpdatePath = false;
 		std::cout << "New Path Calculated\n";
@@ -99,6 +142,18 @@ void App_JumpPointSearch::Render(float deltaTime) const
 	if (!m_vPath.empty())
 		m_GraphRenderer.RenderHighlightedGrid(m_pGridGraph, m_vPath, Elite::Color{ 0.0f,0.0f,1.0f });
 
+	if (m_IsPathSmoothed || m_IsAnyAngle)
+	{
+		for (size_t i = 1; i < m_vWaypoints.size(); ++i)
+		{
+			DEBUGRENDERER2D->DrawSegment(
+				m_pGridGraph->GetNodeWorldPos(m_vWaypoints[i - 1]->GetIndex()),
+				m_pGridGraph->GetNodeWorldPos(m_vWaypoints[i]->GetIndex()),
+				Elite::Color{ 1.0f,0.0f,1.0f },
+				-1.0f);
+		}
+	}
+
 	if(m_ShowJumpPoints)
 	{
 		if(!m_vPath.empty())
@@ -202,9 +257,32 @@ void App_JumpPointSearch::UpdateImGui()
 				m_pHeuristicFunction = Elite::HeuristicFunctions::Chebyshev;
 				break;
 			}
+
+			// the subgoal graph keeps the heuristic it was made with
+			SAFE_DELETE(m_pSubgoalGraph)
 		}
 		ImGui::Spacing();
 
+		// the level file can be mapped straight into memory, so loading doesn't parse anything
+		if (ImGui::Button("Save Level"))
+		{
+			Elite::BinaryFileWriter file{};
+			m_pGridGraph->Save(file);
+			file.Save(m_LevelPath);
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Load Level"))
+		{
+			// the path finders of this app only work with a grid of its own size, other levels leave the grid as it is
+			const Elite::BinaryFile file{ m_LevelPath };
+			int columns{}, rows{};
+			if (m_pGridGraph->GetFileGridSize(file, columns, rows) && columns == m_Columns && rows == m_Rows
+				&& m_pGridGraph->Load(file))
+			{
+				m_ShouldUpdatePath = true;
+			}
+		}
+
 		ImGui::Separator();
 		ImGui::Spacing();
 		ImGui::Checkbox("Show Debug Options", &m_ShowDebugOptions);
@@ -218,6 +296,17 @@ void App_JumpPointSearch::UpdateImGui()
 	{
 		ImGui::Begin("JPS Debug Options");
 		ImGui::Checkbox("Show Jump Points", &m_ShowJumpPoints);
+		if (ImGui::Checkbox("Terrain Aware", &m_IsTerrainAware))
+			m_ShouldUpdatePath = true;
+		if (ImGui::Checkbox("Closest Reachable Fallback", &m_IsFallingBackToClosest))
+			m_ShouldUpdatePath = true;
+		ImGui::Checkbox("Show Smoothed Path", &m_IsPathSmoothed);
+		if (ImGui::Checkbox("Any Angle Path (Lazy Theta*)", &m_IsAnyAngle))
+			m_ShouldUpdatePath = true;
+		if (ImGui::Checkbox("Use Subgoal Graph", &m_IsUsingSubgoalGraph))
+			m_ShouldUpdatePath = true;
+		if (m_IsUsingSubgoalGraph && m_IsSubgoalGraphBypassed)
+			ImGui::Text("Path by JPS (terrain or unreachable goal)");
 		ImGui::End();
 	}
 }
@@ -2,6 +2,7 @@
 
 #include "framework/EliteInterfaces/EIApp.h"
 #include "framework/EliteAI/EliteGraphs/EGridGraph.h"
+#include "framework/EliteAI/EliteGraphs/EliteGraphAlgorithms/ESubgoalGraph.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphUtilities\EGraphEditor.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphUtilities\EGraphRenderer.h"
 #include "projects/Helpers.h"
@@ -22,13 +23,15 @@ private:
 	// Data Members
 
 	// Grid data members
-	Elite::GridGraph<Elite::GridTerrainNode, Elite::GraphConnection>* m_pGridGraph;
+	Elite::GridGraph<Elite::CompactGridNode, Elite::CompactGraphConnection>* m_pGridGraph;
+	Elite::SubgoalGraph<Elite::CompactGridNode, Elite::CompactGraphConnection>* m_pSubgoalGraph{};
 	Elite::Heuristic m_pHeuristicFunction{ Elite::HeuristicFunctions::Chebyshev };
 	Elite::EGraphEditor m_GraphEditor;
 	Elite::EGraphRenderer m_GraphRenderer;
 	static constexpr int m_Columns{20};
 	static constexpr int m_Rows{20};
 	static constexpr int m_CellSize{15};
+	const std::string m_LevelPath{ "JumpPointSearch.level" };
 
 	int m_SelectedHeuristic{4};
 	bool m_IsGridDrawn{ true };
@@ -37,7 +40,8 @@ private:
 	bool m_IsConnectionCostsDrawn{};
 
 	// PathFinding data members
-	std::vector<Elite::GridTerrainNode*> m_vPath;
+	std::vector<Elite::CompactGridNode*> m_vPath;
+	std::vector<Elite::CompactGridNode*> m_vWaypoints;
 	std::vector<NodeForRender> m_JumpPoints;
 	int startPathIdx{};
 	int endPathIdx{};
@@ -46,6 +50,12 @@ private:
 	bool m_IsStartNodeSelected{};
 	bool m_ShowDebugOptions{};
 	bool m_ShowJumpPoints{};
+	bool m_IsTerrainAware{ true };
+	bool m_IsFallingBackToClosest{ true }; // walk as close as possible to a goal that can't be reached
+	bool m_IsPathSmoothed{};
+	bool m_IsAnyAngle{};
+	bool m_IsUsingSubgoalGraph{};
+	bool m_IsSubgoalGraphBypassed{}; // the last path came from JPS, the subgoal graph can't give it
 	
 	bool m_ShouldUpdatePath{};
 	
@@ -11,6 +11,7 @@ using namespace Elite;
 
 #include "framework\EliteAI\EliteGraphs\ENavGraph.h"
 #include "framework\EliteAI\EliteGraphs\EliteGraphAlgorithms\EAStar.h"
+#include "framework\EliteAI\EliteGraphs\EGraphOverlay.h"
 
 
 
@@ -52,7 +53,7 @@ void App_NavMeshGraph::Start()
 	std::list<Elite::Vector2> baseBox
 	{ { -60, 30 },{ -60, -30 },{ 60, -30 },{ 60, 30 } };
 
-	m_pNavGraph = new Elite::NavGraph(Elite::Polygon(baseBox), m_AgentRadius);
+	m_pNavGraph = new Elite::NavGraph(Elite::Polygon(baseBox), m_AgentRadius, m_TileSize);
 
 	//----------- AGENT ------------
 	m_pSeekBehavior = new Seek();
@@ -79,6 +80,20 @@ void App_NavMeshGraph::Update(float deltaTime)
 		m_vPath = FindPath(m_pAgent->GetPosition(), mouseTarget);
 	}
 
+	//Place an obstacle, only the tiles of the navigation mesh around it are triangulated again
+	if (INPUTMANAGER->IsMouseButtonUp(InputMouseButton::eLeft))
+	{
+		auto mouseData = INPUTMANAGER->GetMouseData(Elite::InputType::eMouseButton, Elite::InputMouseButton::eLeft);
+		Elite::Vector2 mousePos = DEBUGRENDERER2D->GetActiveCamera()->ConvertScreenToWorld(
+			Elite::Vector2((float)mouseData.X, (float)mouseData.Y));
+		m_vNavigationColliders.push_back(new NavigationColliderElement(mousePos, 4.0f, 4.0f));
+		m_NrOfRebuiltTiles = m_pNavGraph->UpdateNavigationMesh();
+
+		//The old path can run through the new obstacle
+		if (!m_vPath.empty())
+			m_vPath = FindPath(m_pAgent->GetPosition(), m_vPath.back());
+	}
+
 	//Check if a path exist and move to the following point
 	if (!m_vPath.empty())
 	{
@@ -179,40 +194,32 @@ std::vector<Elite::Vector2> App_NavMeshGraph::FindPath(Elite::Vector2 startPos,
 		if (startTriangle != endTriangle)
 		{
 			//=> Start looking for a path
-			//Copy the graph
-			auto cloneGraph{ m_pNavGraph->Clone() };
-			auto graph2DClone{ std::static_pointer_cast<NavGraph>(cloneGraph) };
-			//int nextLineIdx{ int(navMeshTriangles->GetLines().size()) };
+			//Add the start and end node on top of the graph, they are removed again when the overlay goes out of scope
+			GraphOverlay<NavGraphNode, GraphConnection2D> overlay{ m_pNavGraph };
 
-			auto CreateNodeAndConnectToIt{ [&cloneGraph,&graph2DClone](
+			auto CreateNodeAndConnectToIt{ [this,&overlay](
 				const Elite::Vector2& pos,
 				const std::array<int,3>& indexLines)
 			{
 				// Create node
-				const int nextAvailableNode{cloneGraph->GetNextFreeNodeIndex()};
-				
-				
-				NavGraphNode* newNode{ new NavGraphNode(
-					nextAvailableNode,
+				NavGraphNode* newNode{ overlay.AddNode(
 					1, // Line idx doesn't matter in this case
 					pos
 				) };
-				
-				cloneGraph->AddNode(newNode);
 
 				// Add connection to this node
 				for (const int idx : indexLines)
 				{
-					const int nodeIdx{ graph2DClone->GetNodeIdxFromLineIdx(idx) };
+					const int nodeIdx{ m_pNavGraph->GetNodeIdxFromLineIdx(idx) };
 
 					if (nodeIdx != invalid_node_index)
 					{
-						const Elite::Vector2 vecToNode{ cloneGraph->GetNodePos(nodeIdx) - pos };
-						cloneGraph->AddConnection(new GraphConnection2D(
+						const Elite::Vector2 vecToNode{ m_pNavGraph->GetNodePos(nodeIdx) - pos };
+						overlay.AddConnection(
 							nodeIdx,
-							nextAvailableNode,
+							newNode->GetIndex(),
 							vecToNode.Magnitude()
-						));
+						);
 					}
 				}
 
@@ -226,7 +233,7 @@ std::vector<Elite::Vector2> App_NavMeshGraph::FindPath(Elite::Vector2 startPos,
 			auto endNode = CreateNodeAndConnectToIt(endPos, endTriangle->metaData.IndexLines);
 
 			//Run A star on new graph
-			auto pathfinder = AStar<NavGraphNode, GraphConnection2D>(cloneGraph.get(),m_pHeuristicFunction);
+			auto pathfinder = AStar<NavGraphNode, GraphConnection2D>(m_pNavGraph,m_pHeuristicFunction);
 			auto path = pathfinder.FindPath(startNode, endNode);
 			
 			// Save position
@@ -271,6 +278,8 @@ void App_NavMeshGraph::UpdateImGui()
 		//Elements
 		ImGui::Text("CONTROLS");
 		ImGui::Indent();
+		ImGui::Text("LMB: place obstacle");
+		ImGui::Text("MMB: target");
 		ImGui::Unindent();
 
 		ImGui::Spacing();
@@ -282,6 +291,7 @@ void App_NavMeshGraph::UpdateImGui()
 		ImGui::Indent();
 		ImGui::Text("%.3f ms/frame", 1000.0f / ImGui::GetIO().Framerate);
 		ImGui::Text("%.1f FPS", ImGui::GetIO().Framerate);
+		ImGui::Text("%d tiles rebuilt", m_NrOfRebuiltTiles);
 		ImGui::Unindent();
 
 		ImGui::Spacing();
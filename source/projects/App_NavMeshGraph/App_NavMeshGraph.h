@@ -51,6 +51,8 @@ private:
 
 	// --Graph--
 	Elite::NavGraph* m_pNavGraph = nullptr;
+	float m_TileSize = 15.0f;
+	int m_NrOfRebuiltTiles = 0;
 	Elite::EGraphRenderer m_GraphRenderer{};
 	Elite::Heuristic m_pHeuristicFunction = Elite::HeuristicFunctions::Chebyshev;
 	
@@ -56,9 +56,15 @@ void App_PathfindingAStar::Update(float deltaTime)
 			startPathIdx = closestNode;
 			m_UpdatePath = true;
 		}
+		else if ((SDL_GetModState() & KMOD_CTRL) != 0 && closestNode != invalid_node_index)
+		{
+			m_ExtraGoalIndices.emplace_back(closestNode);
+			m_UpdatePath = true;
+		}
 		else
 		{
 			endPathIdx = closestNode;
+			m_ExtraGoalIndices.clear();
 			m_UpdatePath = true;
 		}
 	}
@@ -90,10 +96,11 @@ void App_PathfindingAStar::Update(float deltaTime)
 		// AStar PathFinding
 		auto pathfinder = AStar<GridTerrainNode, GraphConnection>(m_pGridGraph, m_pHeuristicFunction);
 		auto startNode = m_pGridGraph->GetNode(startPathIdx);
-		auto endNode = m_pGridGraph->GetNode(endPathIdx);
-
+		std::vector<GridTerrainNode*> goalNodes{ m_pGridGraph->GetNode(endPathIdx) };
+		for (int goalIdx : m_ExtraGoalIndices)
+			goalNodes.emplace_back(m_pGridGraph->GetNode(goalIdx));
 
-		m_vPath = pathfinder.FindPath(startNode, endNode);
+		m_vPath = pathfinder.FindPath(startNode, goalNodes, m_IsFallingBackToClosest);
 		m_VisitedNode = pathfinder.GetVisitedNodeIdx();
 
 		m_UpdatePath = false;
@@ -125,6 +132,11 @@ void App_PathfindingAStar::Render(float deltaTime) const
 		m_GraphRenderer.RenderHighlightedGrid(m_pGridGraph, { m_pGridGraph->GetNode(endPathIdx) }, END_NODE_COLOR);
 	}
 
+	for (int goalIdx : m_ExtraGoalIndices)
+	{
+		m_GraphRenderer.RenderHighlightedGrid(m_pGridGraph, { m_pGridGraph->GetNode(goalIdx) }, END_NODE_COLOR);
+	}
+
 	//render path below if applicable
 	if (!m_vPath.empty())
 	{
@@ -244,6 +256,7 @@ void App_PathfindingAStar::UpdateImGui()
 		ImGui::Indent();
 		ImGui::Text("LMB: target");
 		ImGui::Text("RMB: start");
+		ImGui::Text("Ctrl+MMB: goal");
 		ImGui::Unindent();
 
 		/*Spacing*/ImGui::Spacing(); ImGui::Separator(); ImGui::Spacing(); ImGui::Spacing();
@@ -314,6 +327,8 @@ void App_PathfindingAStar::UpdateImGui()
 	if (m_ShowDebugOptions)
 	{
 		ImGui::Begin("AStar Debug Options");
+		if (ImGui::Checkbox("Closest Reachable Fallback", &m_IsFallingBackToClosest))
+			m_UpdatePath = true;
 		ImGui::Checkbox("Show Visited Node", &m_ShowVisitedNode);
 		ImGui::Combo("", &m_SelectedShownGradient, "GCost\0FCost\0\0", 2);
 		ImGui::Checkbox("Show Absolute Value", &m_ShowAbsoluteValue);
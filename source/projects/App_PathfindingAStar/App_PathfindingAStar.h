@@ -42,8 +42,10 @@ private:
 	//Pathfinding datamembers
 	int startPathIdx = invalid_node_index;
 	int endPathIdx = invalid_node_index;
+	std::vector<int> m_ExtraGoalIndices; // ctrl + middle mouse, the path goes to the cheapest goal
 	std::vector<Elite::GridTerrainNode*> m_vPath;
 	bool m_UpdatePath = true;
+	bool m_IsFallingBackToClosest = true; // walk as close as possible to a goal that can't be reached
 
 	//Editor and Visualisation
 	Elite::EGraphEditor m_GraphEditor{};
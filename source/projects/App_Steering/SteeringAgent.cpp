@@ -2,38 +2,77 @@
 #include "SteeringAgent.h"
 #include "SteeringBehaviors.h"
 
+Elite::EMemoryPool<SteeringAgent>& SteeringAgent::GetPool()
+{
+	//Never destroyed: objects can still be deleted by other statics at exit, after a local static pool would be gone.
+	//The OS takes the memory back when the process ends
+	static auto* pPool = new Elite::EMemoryPool<SteeringAgent>{ 128 };
+	return *pPool;
+}
+
+void* SteeringAgent::operator new(size_t size)
+{
+	if (size != sizeof(SteeringAgent))
+		return ::operator new(size);
+
+	void* pMemory = GetPool().GetUnitMemory();
+	if (!pMemory)
+		throw std::bad_alloc{};
+	return pMemory;
+}
+
+void SteeringAgent::operator delete(void* pMemory, size_t size)
+{
+	if (size != sizeof(SteeringAgent))
+	{
+		::operator delete(pMemory);
+		return;
+	}
+
+	GetPool().ReleaseUnitMemory(pMemory);
+}
+
 void SteeringAgent::Update(float dt)
 {
 	if(m_pSteeringBehavior)
+		ApplySteering(CalculateSteering(dt), dt);
+}
+
+SteeringOutput SteeringAgent::CalculateSteering(float dt)
+{
+	if (!m_pSteeringBehavior)
+		return SteeringOutput{};
+
+	return m_pSteeringBehavior->CalculateSteering(dt, this);
+}
+
+void SteeringAgent::ApplySteering(SteeringOutput output, float dt)
+{
+	//Linear Movement
+	//***************
+	auto linVel = GetLinearVelocity();
+	auto steeringForce = output.LinearVelocity - linVel;
+	auto acceleration = steeringForce / GetMass();		
+
+	if(m_RenderBehavior)
+	{
+		//DEBUGRENDERER2D->DrawDirection(GetPosition(), acceleration, acceleration.Magnitude(), { 0, 1, 1 ,0.5f }, 0.40f);
+		//DEBUGRENDERER2D->DrawDirection(GetPosition(), linVel, linVel.Magnitude(), { 1, 0, 1 ,0.5f }, 0.40f);
+	}
+	SetLinearVelocity(linVel + (acceleration*dt));
+
+	//Angular Movement
+	//****************
+	if(m_AutoOrient)
+	{
+		auto desiredOrientation = Elite::GetOrientationFromVelocity(GetLinearVelocity());
+		SetRotation(desiredOrientation);
+	}
+	else
 	{
-		auto output = m_pSteeringBehavior->CalculateSteering(dt, this);
-
-		//Linear Movement
-		//***************
-		auto linVel = GetLinearVelocity();
-		auto steeringForce = output.LinearVelocity - linVel;
-		auto acceleration = steeringForce / GetMass();		
-
-		if(m_RenderBehavior)
-		{
-			//DEBUGRENDERER2D->DrawDirection(GetPosition(), acceleration, acceleration.Magnitude(), { 0, 1, 1 ,0.5f }, 0.40f);
-			//DEBUGRENDERER2D->DrawDirection(GetPosition(), linVel, linVel.Magnitude(), { 1, 0, 1 ,0.5f }, 0.40f);
-		}
-		SetLinearVelocity(linVel + (acceleration*dt));
-
-		//Angular Movement
-		//****************
-		if(m_AutoOrient)
-		{
-			auto desiredOrientation = Elite::GetOrientationFromVelocity(GetLinearVelocity());
-			SetRotation(desiredOrientation);
-		}
-		else
-		{
-			if (output.AngularVelocity > m_MaxAngularSpeed)
-				output.AngularVelocity = m_MaxAngularSpeed;
-			SetAngularVelocity(output.AngularVelocity);
-		}
+		if (output.AngularVelocity > m_MaxAngularSpeed)
+			output.AngularVelocity = m_MaxAngularSpeed;
+		SetAngularVelocity(output.AngularVelocity);
 	}
 }
 
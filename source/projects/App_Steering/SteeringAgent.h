@@ -26,6 +26,10 @@ public:
 	void Update(float dt) override;
 	void Render(float dt) override;
 
+	//Update split in two: calculating the steering only reads, applying it writes to the rigid body
+	SteeringOutput CalculateSteering(float dt);
+	void ApplySteering(SteeringOutput output, float dt);
+
 	float GetMaxLinearSpeed() const { return m_MaxLinearSpeed; }
 	void SetMaxLinearSpeed(float maxLinSpeed) { m_MaxLinearSpeed = maxLinSpeed; }
 
@@ -45,16 +49,18 @@ public:
 	void SetRenderBehavior(bool isEnabled) { m_RenderBehavior = isEnabled; }
 	bool CanRenderBehavior() const { return m_RenderBehavior; }
 
-	int GetOldCellIndex() const { return m_OldCellIndex; }
-	void SetOldCellIndex(int value) { m_OldCellIndex = value; }
+	//Agents come from a memory pool so big flocks don't scatter them over the heap, derived agents use the heap
+	static void* operator new(size_t size);
+	static void operator delete(void* pMemory, size_t size);
 	
 protected:
+	static Elite::EMemoryPool<SteeringAgent>& GetPool();
+
 	//--- Datamembers ---
 	ISteeringBehavior* m_pSteeringBehavior = nullptr;
 
 	float m_MaxLinearSpeed = 10.f;
 	float m_MaxAngularSpeed = 10.f;
-	int m_OldCellIndex{};
 	bool m_AutoOrient = false;
 	bool m_RenderBehavior = false;
 };
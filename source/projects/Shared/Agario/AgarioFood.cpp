@@ -29,6 +29,26 @@ AgarioFood::~AgarioFood()
 	SAFE_DELETE(m_pRigidBody);
 }
 
+Elite::EMemoryPool<AgarioFood>& AgarioFood::GetPool()
+{
+	//Leaked on purpose, like the one of SteeringAgent, so food that gets deleted while the program exits still has its pool
+	static auto* pPool = new Elite::EMemoryPool<AgarioFood>{ 64 };
+	return *pPool;
+}
+
+void* AgarioFood::operator new(size_t size)
+{
+	void* pMemory = GetPool().GetUnitMemory();
+	if (!pMemory)
+		throw std::bad_alloc{};
+	return pMemory;
+}
+
+void AgarioFood::operator delete(void* pMemory, size_t size)
+{
+	GetPool().ReleaseUnitMemory(pMemory);
+}
+
 void AgarioFood::Update(float dt)
 {
 }
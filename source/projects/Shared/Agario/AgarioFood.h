@@ -12,9 +12,14 @@ public:
 	bool CanBeDestroyed();
 	Elite::Vector2 GetPosition() { return m_Position; }
 
+	//Food gets spawned and eaten all the time, so it lives in a memory pool
+	static void* operator new(size_t size);
+	static void operator delete(void* pMemory, size_t size);
+
 private:
 	//--Datamemebers--
 	static const float m_Radius;
+	static Elite::EMemoryPool<AgarioFood>& GetPool();
 	
 	Elite::Vector2 m_Position;
 	Elite::Color m_Color;
@@ -43,8 +43,11 @@ void BaseAgent::Render(float dt)
 
 void BaseAgent::TrimToWorld(const Elite::Vector2& bounds) const
 {
-	auto pos = GetPosition();
+	SetPosition(GetTrimmedPosition(GetPosition(), bounds));
+}
 
+Elite::Vector2 BaseAgent::GetTrimmedPosition(Elite::Vector2 pos, const Elite::Vector2& bounds)
+{
 	if (pos.x > bounds.x)
 		pos.x = -bounds.x;
 	else if (pos.x < -bounds.x)
@@ -55,7 +58,7 @@ void BaseAgent::TrimToWorld(const Elite::Vector2& bounds) const
 	else if (pos.y < -bounds.y)
 		pos.y = bounds.y;
 
-	SetPosition(pos);
+	return pos;
 }
 
 void BaseAgent::TrimToWorld(const Elite::Vector2& bottomLeft, const Elite::Vector2& topRight) const
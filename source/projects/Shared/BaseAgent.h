@@ -13,6 +13,8 @@ public:
 	void TrimToWorld(float worldBounds) const { TrimToWorld({ worldBounds,worldBounds }); }
 	void TrimToWorld(const Elite::Vector2& bounds) const;
 	void TrimToWorld(const Elite::Vector2& bottomLeft, const Elite::Vector2& topRight) const;
+	//Position TrimToWorld(bounds) would move the agent to
+	static Elite::Vector2 GetTrimmedPosition(Elite::Vector2 pos, const Elite::Vector2& bounds);
 
 	//Get - Set
 	Elite::Vector2 GetPosition() const { return m_pRigidBody->GetPosition(); }
@@ -21,6 +23,9 @@ public:
 	float GetRotation() const { return m_pRigidBody->GetRotation().x; }
 	void SetRotation(float rot) const { m_pRigidBody->SetRotation({ rot,0.f }); }
 
+	//Every transform change updates the physics broad-phase, setting both at once only does that once
+	void SetTransform(const Elite::Vector2& pos, float rot) const { m_pRigidBody->SetTransform({ pos,{ rot,0.f } }); }
+
 	Elite::Vector2 GetLinearVelocity() const { return m_pRigidBody->GetLinearVelocity(); }
 	void SetLinearVelocity(const Elite::Vector2& linVel) const { m_pRigidBody->SetLinearVelocity(linVel); }
 
@@ -176,6 +176,7 @@ extern bool gRequestShutdown;
 #include "framework/EliteInput/EInputManager.h"
 #include "framework/EliteWindow/EWindow.h"
 #include "framework/EliteTimer/ETimer.h"
+#include "framework/EliteJobs/EJobSystem.h"
 #include "framework/EliteRendering/ERendering.h"
 #include "framework/EliteUI/EImmediateUI.h"
 #include "framework/EliteAI/EliteNavigation/ENavigation.h"
@@ -188,6 +189,7 @@ extern bool gRequestShutdown;
 /* --- FRAMEWORK MACROS ---- */
 #define INPUTMANAGER Elite::EInputManager::GetInstance()
 #define TIMER Elite::ETimer<PLATFORM_ID>::GetInstance()
+#define JOBSYSTEM Elite::EJobSystem::GetInstance()
 #define DEBUGRENDERER2D EliteDebugRenderer2D::GetInstance()
 #define PHYSICSWORLD PhysicsWorld::GetInstance()
 